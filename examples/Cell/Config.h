@@ -2,6 +2,7 @@
 #define CONFIG_H
 
 #include "ConfigBase.h"
+#include "Cutlib.h"
 #include <iostream>
 #include <string>
 #include "Tuple.h"
@@ -23,6 +24,11 @@ public:
 
   std::string output;
 
+  std::string engineName;
+  cutlib::CutlibEngine engine;
+
+  bool compare;
+
 private:
 
   void parse() {
@@ -48,6 +54,9 @@ private:
 
     output = read<std::string>("output", "");
 
+    engineName = read<std::string>("engine", "cell");
+    compare = read<bool>("compare", false);
+
   }
 
 
@@ -58,14 +67,27 @@ private:
       std::cout << "error: 'ndim[3]' must be greater than 0." << std::endl;
       ret = false;
     }
-    if (!(cutPosType == "CutPos32" || cutPosType == "CutPos8")) {
-      std::cout << "error: 'cutPos' must be 'CutPos32' or 'CutPos8'." << std::endl;
+    if (!(cutPosType == "CutPos32" || cutPosType == "CutPos8" ||
+          cutPosType == "CutPos16" || cutPosType == "CutPos10")) {
+      std::cout << "error: 'cutPos' must be 'CutPos32', 'CutPos16', 'CutPos10' or 'CutPos8'." << std::endl;
       ret = false;
     }
     if (!(cutBidType == "CutBid8" || cutBidType == "CutBid5")) {
       std::cout << "error: 'cutBid' must be 'CutBid8' or 'CutBid5'." << std::endl;
       ret = false;
     }
+    if (engineName == "cell") {
+      engine = cutlib::CL_ENGINE_CELL;
+    } else if (engineName == "scanline") {
+      engine = cutlib::CL_ENGINE_SCANLINE;
+    } else if (engineName == "scatter") {
+      engine = cutlib::CL_ENGINE_SCATTER;
+    } else if (engineName == "bvh") {
+      engine = cutlib::CL_ENGINE_BVH;
+    } else {
+      std::cout << "error: 'engine' must be 'cell', 'scanline', 'scatter' or 'bvh'." << std::endl;
+      ret = false;
+    }
 
     return ret;
   }
@@ -81,6 +103,8 @@ public:
     std::cout << "  cutBid:      " << cutBidType << std::endl;
     std::cout << "  polylibConf: " << polylibConf << std::endl;
     std::cout << "  output:      " << output << std::endl;
+    std::cout << "  engine:      " << engineName << std::endl;
+    std::cout << "  compare:     " << (compare ? "on" : "off") << std::endl;
   }
 
 };
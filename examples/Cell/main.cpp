@@ -2,6 +2,7 @@
 #include "Cutlib.h"
 #include "GridAccessor/Cell.h"
 #include "outputVtk.h"
+#include "CutTest.h"
 using namespace cutlib;
 
 #include "Config.h"
@@ -39,6 +40,8 @@ int main(int argc, char* argv[])
   CutPosArray *cutPosArray;
   if (conf.cutPosType == "CutPos32") cutPosArray = new CutPos32Array(conf.ndim);
   if (conf.cutPosType == "CutPos8")  cutPosArray = new CutPos8Array(conf.ndim);
+  if (conf.cutPosType == "CutPos16") cutPosArray = new CutPos16Array(conf.ndim);
+  if (conf.cutPosType == "CutPos10") cutPosArray = new CutPos10Array(conf.ndim);
 
   CutBidArray *cutBidArray;
   if (conf.cutBidType == "CutBid8") cutBidArray = new CutBid8Array(conf.ndim);
@@ -46,10 +49,26 @@ int main(int argc, char* argv[])
 
   std::cout << std::endl << "CalcCutInfo: " << std::endl;
   int ret = CalcCutInfo(conf.ista, conf.nlen,
-                        grid, pl, cutPosArray, cutBidArray);
+                        grid, pl, cutPosArray, cutBidArray, 0, conf.engine);
   std::cout << "return code = " << ret <<  std::endl;
   if (ret) return 1;
 
+  // CL_ENGINE_CELLの結果と比較
+  if (conf.compare && conf.engine != CL_ENGINE_CELL) {
+    CutPosArray* cutPosArray0 = new CutPos32Array(conf.ndim);
+    CutBidArray* cutBidArray0 = new CutBid8Array(conf.ndim);
+    std::cout << std::endl << "CalcCutInfo (CL_ENGINE_CELL): " << std::endl;
+    ret = CalcCutInfo(conf.ista, conf.nlen,
+                      grid, pl, cutPosArray0, cutBidArray0);
+    std::cout << "return code = " << ret <<  std::endl;
+    if (ret) return 1;
+    bool ok = CutTest::compare(CutInfoData(cutPosArray, cutBidArray),
+                               CutInfoData(cutPosArray0, cutBidArray0));
+    delete cutPosArray0;
+    delete cutBidArray0;
+    if (!ok) return 1;
+  }
+
   if (conf.output != "") {
     outputVtk(conf.output, grid, cutPosArray, cutBidArray);
   }
@@ -2,6 +2,7 @@
 #define CONFIG_H
 
 #include "ConfigBase.h"
+#include "Cutlib.h"
 #include <iostream>
 #include <string>
 #include "Tuple.h"
@@ -23,6 +24,14 @@ public:
 
   std::string output;
 
+  std::string engineName;
+  cutlib::CutlibEngine engine;
+
+  bool compare;
+
+  std::string normalEncodingName;
+  cutlib::CutNormalEncoding normalEncoding;
+
   bool reverseNormal;
 
 private:
@@ -50,6 +59,11 @@ private:
 
     output = read<std::string>("output", "");
 
+    engineName = read<std::string>("engine", "cell");
+    compare = read<bool>("compare", false);
+
+    normalEncodingName = read<std::string>("normalEncoding", "vector");
+
     reverseNormal = read<bool>("reverseNormal", false);
 
   }
@@ -62,14 +76,37 @@ private:
       std::cout << "error: 'ndim[3]' must be greater than 0." << std::endl;
       ret = false;
     }
-    if (!(cutPosType == "CutPos32" || cutPosType == "CutPos8")) {
-      std::cout << "error: 'cutPos' must be 'CutPos32' or 'CutPos8'." << std::endl;
+    if (!(cutPosType == "CutPos32" || cutPosType == "CutPos8" ||
+          cutPosType == "CutPos16" || cutPosType == "CutPos10")) {
+      std::cout << "error: 'cutPos' must be 'CutPos32', 'CutPos16', 'CutPos10' or 'CutPos8'." << std::endl;
       ret = false;
     }
     if (!(cutBidType == "CutBid8" || cutBidType == "CutBid5")) {
       std::cout << "error: 'cutBid' must be 'CutBid8' or 'CutBid5'." << std::endl;
       ret = false;
     }
+    if (engineName == "cell") {
+      engine = cutlib::CL_ENGINE_CELL;
+    } else if (engineName == "scanline") {
+      engine = cutlib::CL_ENGINE_SCANLINE;
+    } else if (engineName == "scatter") {
+      engine = cutlib::CL_ENGINE_SCATTER;
+    } else if (engineName == "bvh") {
+      engine = cutlib::CL_ENGINE_BVH;
+    } else {
+      std::cout << "error: 'engine' must be 'cell', 'scanline', 'scatter' or 'bvh'." << std::endl;
+      ret = false;
+    }
+    if (normalEncodingName == "vector") {
+      normalEncoding = cutlib::CL_NORMAL_VECTOR;
+    } else if (normalEncodingName == "oct16") {
+      normalEncoding = cutlib::CL_NORMAL_OCT16;
+    } else if (normalEncodingName == "oct32") {
+      normalEncoding = cutlib::CL_NORMAL_OCT32;
+    } else {
+      std::cout << "error: 'normalEncoding' must be 'vector', 'oct16' or 'oct32'." << std::endl;
+      ret = false;
+    }
 
     return ret;
   }
@@ -85,6 +122,9 @@ public:
     std::cout << "  cutBid:         " << cutBidType << std::endl;
     std::cout << "  polylibConf:    " << polylibConf << std::endl;
     std::cout << "  output:         " << output << std::endl;
+    std::cout << "  engine:         " << engineName << std::endl;
+    std::cout << "  compare:        " << (compare ? "on" : "off") << std::endl;
+    std::cout << "  normalEncoding: " << normalEncodingName << std::endl;
     std::cout << "  reverse normal: " << (reverseNormal ? "on" : "off")  << std::endl;
   }
 
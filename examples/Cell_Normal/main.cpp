@@ -2,6 +2,7 @@
 #include "Cutlib.h"
 #include "GridAccessor/Cell.h"
 #include "outputVtk.h"
+#include "CutTest.h"
 using namespace cutlib;
 
 #include "Config.h"
@@ -39,18 +40,42 @@ int main(int argc, char* argv[])
   CutPosArray* cutPosArray;
   if (conf.cutPosType == "CutPos32") cutPosArray = new CutPos32Array(conf.ndim);
   if (conf.cutPosType == "CutPos8")  cutPosArray = new CutPos8Array(conf.ndim);
+  if (conf.cutPosType == "CutPos16") cutPosArray = new CutPos16Array(conf.ndim);
+  if (conf.cutPosType == "CutPos10") cutPosArray = new CutPos10Array(conf.ndim);
 
   CutBidArray* cutBidArray;
   if (conf.cutBidType == "CutBid8") cutBidArray = new CutBid8Array(conf.ndim);
   if (conf.cutBidType == "CutBid5") cutBidArray = new CutBid5Array(conf.ndim);
 
   CutNormalArray* cutNormalArray = new CutNormalArray(conf.ndim);
+  cutNormalArray->setEncoding(conf.normalEncoding);
 
   std::cout << std::endl << "CalcCutInfo: " << std::endl;
   int ret = CalcCutInfo(conf.ista, conf.nlen,
-                        grid, pl, cutPosArray, cutBidArray, cutNormalArray);
+                        grid, pl, cutPosArray, cutBidArray, cutNormalArray,
+                        conf.engine);
   std::cout << "return code = " << ret <<  std::endl;
 
+  // CL_ENGINE_CELL, CL_NORMAL_VECTORの結果と比較
+  if (conf.compare) {
+    CutPosArray* cutPosArray0 = new CutPos32Array(conf.ndim);
+    CutBidArray* cutBidArray0 = new CutBid8Array(conf.ndim);
+    CutNormalArray* cutNormalArray0 = new CutNormalArray(conf.ndim);
+    std::cout << std::endl << "CalcCutInfo (CL_ENGINE_CELL, CL_NORMAL_VECTOR): " << std::endl;
+    ret = CalcCutInfo(conf.ista, conf.nlen,
+                      grid, pl, cutPosArray0, cutBidArray0, cutNormalArray0);
+    std::cout << "return code = " << ret <<  std::endl;
+    if (ret) return 1;
+    bool ok = CutTest::compare(CutInfoData(cutPosArray, cutBidArray),
+                               CutInfoData(cutPosArray0, cutBidArray0));
+    bool okNormal = CutTest::compareNormal(cutNormalArray, cutNormalArray0,
+                                           GetOctNormalMaxError(conf.normalEncoding));
+    delete cutPosArray0;
+    delete cutBidArray0;
+    delete cutNormalArray0;
+    if (!ok || !okNormal) return 1;
+  }
+
   if (conf.output != "") {
     outputVtk(conf.output, grid, cutPosArray, cutBidArray,
               cutNormalArray, conf.reverseNormal);
@@ -68,8 +68,9 @@ private:
       std::cout << "error: 'dIndex' must be greater or equaul to 0." << std::endl;
       ret = false;
     }
-    if (!(cutPosType == "CutPos32" || cutPosType == "CutPos8")) {
-      std::cout << "error: 'cutPos' must be 'CutPos32' or 'CutPos8'." << std::endl;
+    if (!(cutPosType == "CutPos32" || cutPosType == "CutPos8" ||
+          cutPosType == "CutPos16" || cutPosType == "CutPos10")) {
+      std::cout << "error: 'cutPos' must be 'CutPos32', 'CutPos16', 'CutPos10' or 'CutPos8'." << std::endl;
       ret = false;
     }
     if (!(cutBidType == "CutBid8" || cutBidType == "CutBid5")) {
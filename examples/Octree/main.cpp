@@ -26,6 +26,8 @@ int main(int argc, char* argv[])
   CutPosOctree *cutPos;
   if (conf.cutPosType == "CutPos32") cutPos= new CutPos32Octree(conf.dIndex);
   if (conf.cutPosType == "CutPos8")  cutPos= new CutPos8Octree(conf.dIndex);
+  if (conf.cutPosType == "CutPos16") cutPos= new CutPos16Octree(conf.dIndex);
+  if (conf.cutPosType == "CutPos10") cutPos= new CutPos10Octree(conf.dIndex);
 
   CutBidOctree *cutBid;
   if (conf.cutBidType == "CutBid8") cutBid= new CutBid8Octree(conf.dIndex+cutPos->getSizeInFloat());
@@ -96,6 +96,10 @@ public:
   static bool compare(const CutInfoData& cutInfoData,
                       const CutInfoData& cutInfoData0, float tol = 2.0/256);
 
+  // tol: 角度誤差の許容値(度)
+  static bool compareNormal(const CutNormalArray* cutNormal,
+                            const CutNormalArray* cutNormal0, double tol = 0.0);
+
 
 };
 
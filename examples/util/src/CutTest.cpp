@@ -1,5 +1,7 @@
 #include <iostream>
 #include <cassert>
+#include <vector>
+#include <cmath>
 #include "CutTest.h"
 
 using namespace cutlib;
@@ -71,14 +73,19 @@ void CutInfoData::write(const std::string& file) const
   size_t ny = ey - sy + 1;
   size_t nz = ez - sz + 1;
 
+  std::vector<float> posRow(6*nx);
+  std::vector<BidType> bidRow(6*nx);
+
   for (int k = sz; k <= ez; k++) {
     for (int j = sy; j <= ey; j++) {
+      cutPos->getPosRange(sx, ex+1, j, k, &posRow[0]);
+      cutBid->getBidRange(sx, ex+1, j, k, &bidRow[0]);
       for (int i = sx; i <= ex; i++) {
         size_t ijk = (i-sx) + (j-sy) * nx + (k-sz) * nx*ny;
         for (int d = 0; d < 6; d++) {
-          BidType bid = cutBid->getBid(i,j,k,d);
+          BidType bid = bidRow[6*(i-sx)+d];
           if (bid > 0) {
-            float pos = cutPos->getPos(i,j,k,d);
+            float pos = posRow[6*(i-sx)+d];
           //assert(pos < 1.0);
             assert(pos <= 1.0);
             os << Cut(ijk, d, bid, pos) << std::endl;
@@ -136,13 +143,20 @@ bool CutTest::compare(const CutInfoData& cutInfoData,
 
   const int MaxDiffPrint = 200;
 
+  std::vector<float> posRow(6*nx), posRow0(6*nx);
+  std::vector<BidType> bidRow(6*nx), bidRow0(6*nx);
+
   for (size_t k = sz; k <= ez; k++) {
     for (size_t j = sy; j <= ey; j++) {
+      cutPos->getPosRange(sx, ex+1, j, k, &posRow[0]);
+      cutBid->getBidRange(sx, ex+1, j, k, &bidRow[0]);
+      cutPos0->getPosRange(sx, ex+1, j, k, &posRow0[0]);
+      cutBid0->getBidRange(sx, ex+1, j, k, &bidRow0[0]);
       for (size_t i = sx; i <= ex; i++) {
         size_t ijk = (i-sx) + (j-sy) * nx + (k-sz) * nx*ny;
         for (int d = 0; d < 6; d++) {
-          BidType bid = cutBid->getBid(i,j,k,d);
-          BidType bid0 = cutBid0->getBid(i,j,k,d);
+          BidType bid = bidRow[6*(i-sx)+d];
+          BidType bid0 = bidRow0[6*(i-sx)+d];
           if (bid != bid0) {
             if (nDiff < MaxDiffPrint) {
               std::cout << "**diff: (" << i << "," << j << "," << k << "):"
@@ -151,13 +165,13 @@ bool CutTest::compare(const CutInfoData& cutInfoData,
                 std::cout << "    bid = 0" << std::endl;
               } else {
                 std::cout << "    bid = " << (int)bid <<  ", pos = "
-                          << cutPos->getPos(i,j,k,d) << std::endl;
+                          << posRow[6*(i-sx)+d] << std::endl;
               }
               if (bid0 == 0) {
                 std::cout << "    bid0 = 0" << std::endl;
               } else {
                 std::cout << "    bid0 = " << (int)bid0 <<  ", pos0 = "
-                          << cutPos0->getPos(i,j,k,d) << std::endl;
+                          << posRow0[6*(i-sx)+d] << std::endl;
               }
             }
             if (nDiff == MaxDiffPrint) {
@@ -167,8 +181,8 @@ bool CutTest::compare(const CutInfoData& cutInfoData,
             continue;
           }
           if (bid > 0) {
-            float pos = cutPos->getPos(i,j,k,d);
-            float pos0 = cutPos0->getPos(i,j,k,d);
+            float pos = posRow[6*(i-sx)+d];
+            float pos0 = posRow0[6*(i-sx)+d];
             float err = fabsf(pos - pos0);
             errMax = std::max(err, errMax);
           }
@@ -190,3 +204,70 @@ bool CutTest::compare(const CutInfoData& cutInfoData,
   return true;
 }
 
+
+bool CutTest::compareNormal(const CutNormalArray* cutNormal,
+                            const CutNormalArray* cutNormal0, double tol)
+{
+  std::cout << "compare CutNormalArray ..." << std::endl;
+
+  if (cutNormal->getStartX() != cutNormal0->getStartX() ||
+      cutNormal->getStartY() != cutNormal0->getStartY() ||
+      cutNormal->getStartZ() != cutNormal0->getStartZ() ||
+      cutNormal->getSizeX() != cutNormal0->getSizeX() ||
+      cutNormal->getSizeY() != cutNormal0->getSizeY() ||
+      cutNormal->getSizeZ() != cutNormal0->getSizeZ()) {
+    std::cout << "*** CutNormal region differs" << std::endl;
+    std::cout << "... NG." << std::endl;
+    return false;
+  }
+
+  int sx = cutNormal->getStartX();
+  int sy = cutNormal->getStartY();
+  int sz = cutNormal->getStartZ();
+  int ex = sx + (int)cutNormal->getSizeX() - 1;
+  int ey = sy + (int)cutNormal->getSizeY() - 1;
+  int ez = sz + (int)cutNormal->getSizeZ() - 1;
+
+  size_t nDiff = 0;
+  double errMax = 0.0;
+
+  for (int k = sz; k <= ez; k++) {
+    for (int j = sy; j <= ey; j++) {
+      for (int i = sx; i <= ex; i++) {
+        for (int d = 0; d < 6; d++) {
+          bool cut = cutNormal->getNormalIndex(cutNormal->getIndex(i, j, k), d) >= 0;
+          bool cut0 = cutNormal0->getNormalIndex(cutNormal0->getIndex(i, j, k), d) >= 0;
+          if (cut != cut0) {
+            std::cout << "**diff: (" << i << "," << j << "," << k << "):"
+                                   << d << std::endl;
+            nDiff++;
+            continue;
+          }
+          if (!cut) continue;
+          Normal n, n0;
+          cutNormal->getNormal(i, j, k, d, n);
+          cutNormal0->getNormal(i, j, k, d, n0);
+          // 1に近い内積のacosは丸め誤差が大きいので外積の大きさと組み合わせる
+          double cx = (double)n[1] * n0[2] - (double)n[2] * n0[1];
+          double cy = (double)n[2] * n0[0] - (double)n[0] * n0[2];
+          double cz = (double)n[0] * n0[1] - (double)n[1] * n0[0];
+          double dot = (double)n[0] * n0[0] + (double)n[1] * n0[1]
+                     + (double)n[2] * n0[2];
+          double err = atan2(sqrt(cx*cx + cy*cy + cz*cz), dot) * 45.0 / atan(1.0);
+          errMax = std::max(err, errMax);
+        }
+      }
+    }
+  }
+
+  std::cout << "# of normal difference = " << nDiff << std::endl;
+  std::cout << "max angle error = " << errMax << " deg" << std::endl;
+
+  if (nDiff > 0 || errMax > tol) {
+    std::cout << "... NG." << std::endl;
+    return false;
+  }
+
+  std::cout << "... Good." << std::endl;
+  return true;
+}
@@ -137,14 +137,17 @@ void outputVtk(const std::string& file, const GridAccessor* grid,
   VecBid vecBidM, vecBidP;
   VecNormal vecNormalM, vecNormalP;
 
+  std::vector<float> posRow(6*nlen[0]);
+  std::vector<BidType> bidRow(6*nlen[0]);
+
   for (int k = ista[2]; k < ista[2]+nlen[2]; k++) {
     for (int j = ista[1]; j < ista[1]+nlen[1]; j++) {
+      cp->getPosRange(ista[0], ista[0]+nlen[0], j, k, &posRow[0]);
+      cb->getBidRange(ista[0], ista[0]+nlen[0], j, k, &bidRow[0]);
       for (int i = ista[0]; i < ista[0]+nlen[0]; i++) {
-        float pos6[6];
-        BidType bid6[6];
+        float* pos6 = &posRow[6*(i-ista[0])];
+        BidType* bid6 = &bidRow[6*(i-ista[0])];
         Normal normal6[6];
-        cp->getPos(i, j, k, pos6);
-        cb->getBid(i, j, k, bid6);
         if (cn) cn->getNormal(i, j, k, normal6);
 
         double center_d[3];
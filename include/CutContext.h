@@ -0,0 +1,115 @@
+/*
+###################################################################################
+#
+# Cutlib - Cut Information Library
+#
+# Copyright (c) 2010-2011 VCAD System Research Program, RIKEN.
+# All rights reserved.
+#
+# Copyright (c) 2012-2015 Advanced Institute for Computational Science, RIKEN.
+# All rights reserved.
+#
+# Copyright (c) 2016-2017 Research Institute for Information Technology (RIIT), Kyushu University.
+# All rights reserved.
+#
+###################################################################################
+*/
+
+
+///
+/// @file
+/// @brief 交点情報計算コンテキストクラス 宣言
+///
+
+#ifndef CUTLIB_CONTEXT_H
+#define CUTLIB_CONTEXT_H
+
+#include <string>
+#include <vector>
+
+#include "Cutlib.h"
+
+
+namespace cutlib {
+
+class CutTriangleStore;
+class CutBvh;
+
+/// 交点情報計算コンテキストクラス.
+///
+///  計算対象三角形ポリゴン(交点計算用キャッシュを含む),BVH,
+///  スレッド毎の交点ポリゴンリストを保持し，CalcCutInfoの複数回の
+///  呼び出し(時間ステップ毎の再計算等)で再利用する.
+///  各呼び出しではPolylib::search_polygonsを呼ばない.
+///
+///  @note 三角形ポリゴンの追加,削除,移動を行った場合は，
+///        次の呼び出し前にinvalidate()またはrefresh()を呼ぶこと
+///  @note 一つのコンテキストを複数スレッドから同時に使用しないこと
+///
+class CutContext {
+
+  const Polylib* pl;                   ///< Polylibクラスオブジェクト
+  std::vector<std::string> pgList;     ///< 計算対象ポリゴングループのパス名リスト
+
+  CutTriangleStore* store;  ///< 計算対象三角形ポリゴン(未構築時は0)
+  CutBvh* bvh;              ///< BVH(未構築時は0)
+
+  CutPolygonList* cutPolygonList;  ///< スレッド毎の交点ポリゴンリスト
+  int nThread;                     ///< 交点ポリゴンリスト数
+
+public:
+
+  /// コンストラクタ(全ポリゴングループ).
+  ///
+  ///  @param[in] pl Polylibクラスオブジェクト
+  ///
+  CutContext(const Polylib* pl);
+
+  /// コンストラクタ(ポリゴングループ指定).
+  ///
+  ///  @param[in] pl Polylibクラスオブジェクト
+  ///  @param[in] pgList 計算対象ポリゴングループのパス名リスト
+  ///
+  CutContext(const Polylib* pl, const std::vector<std::string>& pgList);
+
+  /// デストラクタ.
+  ~CutContext();
+
+  /// 保持データを無効化.
+  ///
+  ///  次に使用される時に三角形ポリゴンを再収集する
+  ///
+  void invalidate();
+
+  /// 保持データを直ちに再構築.
+  void refresh();
+
+  /// Polylibクラスオブジェクトを得る.
+  const Polylib* getPolylib() const { return pl; }
+
+  /// 計算対象三角形ポリゴンを得る(未構築なら構築).
+  const CutTriangleStore* getStore();
+
+  /// BVHを得る(未構築なら構築).
+  const CutBvh* getBvh();
+
+  /// スレッド毎の交点ポリゴンリストを得る.
+  ///
+  ///  @param[in] n スレッド数
+  ///  @return 空の交点ポリゴンリストn個の配列
+  ///
+  CutPolygonList* getPolygonList(int n);
+
+private:
+
+  /// コピーコンストラクタ(使用禁止).
+  CutContext(const CutContext&);
+
+  /// 代入演算子(使用禁止).
+  CutContext& operator=(const CutContext&);
+
+};
+
+} // namespace cutlib
+
+#endif // CUTLIB_CONTEXT_H
@@ -0,0 +1,173 @@
+/*
+###################################################################################
+#
+# Cutlib - Cut Information Library
+#
+# Copyright (c) 2010-2011 VCAD System Research Program, RIKEN.
+# All rights reserved.
+#
+# Copyright (c) 2012-2015 Advanced Institute for Computational Science, RIKEN.
+# All rights reserved.
+#
+# Copyright (c) 2016-2017 Research Institute for Information Technology (RIIT), Kyushu University.
+# All rights reserved.
+#
+###################################################################################
+*/
+
+
+/// @file
+/// @brief 交点情報配列用メモリアロケータ
+///
+
+#ifndef CUTINFO_ALLOCATOR_H
+#define CUTINFO_ALLOCATOR_H
+
+#include <cstddef>   // for size_t
+#include <new>       // for bad_alloc
+#include <stdlib.h>  // for posix_memalign, free
+
+#ifdef __linux__
+#include <sys/mman.h>  // for madvise
+#endif
+
+namespace cutlib {
+
+/// @defgroup CutAllocator 交点情報配列用メモリアロケータ
+//@{
+
+/// 交点情報配列用メモリアロケータ基底クラス.
+///
+///  交点情報配列のコンストラクタに渡すと一次元データ領域の確保,解放に使用する.
+///  渡さない(0の)場合は従来通りnew[]/delete[]を使用する.
+///  利用者が独自のメモリプール等を使う場合はこのクラスを継承する.
+///
+///  @note アロケータは配列より長く存在すること
+///
+class CutAllocator {
+public:
+  /// デストラクタ.
+  virtual ~CutAllocator() {}
+
+  /// 領域を確保.
+  ///
+  ///  @param[in] size 確保するバイト数
+  ///  @return 確保した領域の先頭(失敗時はstd::bad_allocを送出)
+  ///
+  virtual void* allocate(size_t size) = 0;
+
+  /// 領域を解放.
+  ///
+  ///  @param[in] p allocateで確保した領域の先頭
+  ///  @param[in] size 確保時のバイト数
+  ///
+  virtual void deallocate(void* p, size_t size) = 0;
+};
+
+
+/// アライメント指定アロケータ.
+class CutAlignedAllocator : public CutAllocator {
+
+  size_t alignment;  ///< アライメント(バイト, 2のべき乗かつsizeof(void*)の倍数)
+
+public:
+  /// コンストラクタ.
+  ///
+  ///  @param[in] alignment アライメント(バイト)
+  ///
+  CutAlignedAllocator(size_t alignment = 64) : alignment(alignment) {}
+
+  /// 領域を確保.
+  void* allocate(size_t size) {
+    void* p = 0;
+    if (posix_memalign(&p, alignment, size > 0 ? size : 1) != 0) {
+      throw std::bad_alloc();
+    }
+    return p;
+  }
+
+  /// 領域を解放.
+  void deallocate(void* p, size_t /* size */) { free(p); }
+
+  /// アライメントを得る.
+  size_t getAlignment() const { return alignment; }
+};
+
+
+/// 透過的ヒュージページ(THP)アロケータ.
+///
+///  ヒュージページ境界に揃えて確保し，madvise(MADV_HUGEPAGE)で
+///  ヒュージページの使用を要求する(Linux以外,未対応カーネルでは
+///  通常ページのまま動作する).
+///
+class CutHugePageAllocator : public CutAlignedAllocator {
+public:
+  /// デフォルトのヒュージページサイズ(2MB).
+  static const size_t DefaultPageSize = 2 * 1024 * 1024;
+
+  /// コンストラクタ.
+  ///
+  ///  @param[in] pageSize ヒュージページサイズ(バイト)
+  ///
+  CutHugePageAllocator(size_t pageSize = DefaultPageSize)
+    : CutAlignedAllocator(pageSize) {}
+
+  /// 領域を確保.
+  void* allocate(size_t size) {
+    void* p = CutAlignedAllocator::allocate(size);
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+    madvise(p, size, MADV_HUGEPAGE);
+#endif
+    return p;
+  }
+};
+
+
+/// 利用者指定バッファからの切り出しアロケータ.
+///
+///  利用者が用意した領域の先頭から順にアライメントを揃えて切り出す.
+///  個別の解放は行わず，領域全体は利用者が管理する.
+///
+class CutPoolAllocator : public CutAllocator {
+
+  char* pool;        ///< 領域先頭
+  size_t poolSize;   ///< 領域バイト数
+  size_t used;       ///< 使用済みバイト数
+  size_t alignment;  ///< アライメント(バイト, 2のべき乗)
+
+public:
+  /// コンストラクタ.
+  ///
+  ///  @param[in] pool 利用者が確保した領域
+  ///  @param[in] poolSize 領域バイト数
+  ///  @param[in] alignment アライメント(バイト)
+  ///
+  CutPoolAllocator(void* pool, size_t poolSize, size_t alignment = 64)
+    : pool(static_cast<char*>(pool)), poolSize(poolSize), used(0),
+      alignment(alignment) {}
+
+  /// 領域を確保.
+  void* allocate(size_t size) {
+    size_t addr = reinterpret_cast<size_t>(pool) + used;
+    size_t offset = ((addr + alignment - 1) & ~(alignment - 1))
+                  - reinterpret_cast<size_t>(pool);
+    if (offset > poolSize || size > poolSize - offset) throw std::bad_alloc();
+    used = offset + size;
+    return pool + offset;
+  }
+
+  /// 領域を解放(何もしない).
+  void deallocate(void* /* p */, size_t /* size */) {}
+
+  /// 切り出し位置を先頭に戻す(切り出した領域を全て再利用可能にする).
+  void reset() { used = 0; }
+
+  /// 使用済みバイト数を得る.
+  size_t getUsedSize() const { return used; }
+};
+
+//@} end group CutAllocator
+
+} // namespace cutlib
+
+#endif // CUTINFO_ALLOCATOR_H
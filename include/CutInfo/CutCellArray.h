@@ -0,0 +1,370 @@
+/*
+###################################################################################
+#
+# Cutlib - Cut Information Library
+#
+# Copyright (c) 2010-2011 VCAD System Research Program, RIKEN.
+# All rights reserved.
+#
+# Copyright (c) 2012-2015 Advanced Institute for Computational Science, RIKEN.
+# All rights reserved.
+#
+# Copyright (c) 2016-2017 Research Institute for Information Technology (RIIT), Kyushu University.
+# All rights reserved.
+#
+###################################################################################
+*/
+
+
+/// @file
+/// @brief セル毎交点情報レコード配列クラス
+///
+
+#ifndef CUTINFO_CELL_ARRAY_H
+#define CUTINFO_CELL_ARRAY_H
+
+#include "CutInfoArray.h"
+#include "CutNormalArray.h"
+
+namespace cutlib {
+
+/// @defgroup CutCellArray セル毎交点情報レコード配列クラス
+//@{
+
+/// セル毎交点情報レコード(交点座標,境界ID).
+template<typename CUT_POS, typename CUT_BID>
+struct CutCellRecord {
+  typedef CUT_POS PosType;  ///< 交点座標基本型
+  typedef CUT_BID BidType;  ///< 境界ID基本型
+
+  CUT_POS pos;  ///< 交点座標
+  CUT_BID bid;  ///< 境界ID
+};
+
+/// セル毎交点情報レコード(交点座標,境界ID,法線ベクトルデータ格納位置).
+///
+///  法線ベクトルデータ格納位置は16ビット(NoNormalは交点なし)
+///
+template<typename CUT_POS, typename CUT_BID>
+struct CutCellNormalRecord {
+  typedef CUT_POS PosType;  ///< 交点座標基本型
+  typedef CUT_BID BidType;  ///< 境界ID基本型
+
+  /// 交点なしを表す法線ベクトルデータ格納位置.
+  enum { NoNormal = 0xffff };
+
+  CUT_POS pos;         ///< 交点座標
+  CUT_BID bid;         ///< 境界ID
+  uint16_t normal[6];  ///< 法線ベクトルデータ格納位置
+};
+
+/// レコードの法線ベクトルデータ格納位置を設定.
+template<typename CUT_POS, typename CUT_BID>
+inline void SetCellNormal(CutCellNormalRecord<CUT_POS, CUT_BID>& r, int d, int id)
+{
+  r.normal[d] = (uint16_t)(id < 0 ? (int)CutCellNormalRecord<CUT_POS, CUT_BID>::NoNormal
+                                  : id);
+}
+
+/// レコードの法線ベクトルデータ格納位置を得る(交点なしの時は-1).
+template<typename CUT_POS, typename CUT_BID>
+inline int GetCellNormal(const CutCellNormalRecord<CUT_POS, CUT_BID>& r, int d)
+{
+  return r.normal[d] == (int)CutCellNormalRecord<CUT_POS, CUT_BID>::NoNormal
+         ? -1 : r.normal[d];
+}
+
+/// レコードをクリア(交点座標1.0,境界ID0).
+template<typename CUT_POS, typename CUT_BID>
+inline void ClearCellRecord(CutCellRecord<CUT_POS, CUT_BID>& r)
+{
+  ClearCutPos(r.pos);
+  ClearCutBid(r.bid);
+}
+
+/// レコードをクリア(交点座標1.0,境界ID0,法線ベクトルデータなし).
+template<typename CUT_POS, typename CUT_BID>
+inline void ClearCellRecord(CutCellNormalRecord<CUT_POS, CUT_BID>& r)
+{
+  ClearCutPos(r.pos);
+  ClearCutBid(r.bid);
+  for (int d = 0; d < 6; d++) SetCellNormal(r, d, -1);
+}
+
+
+/// セル毎交点情報レコード配列クラステンプレート.
+///
+///  1セル分の交点座標,境界ID(,法線ベクトルデータ格納位置)を1レコードに
+///  まとめ，キャッシュライン境界に揃えて格納する.
+///  getPosArray(), getBidArray()で得られるビューを
+///  CalcCutInfoの交点座標配列,境界ID配列として渡すと直接書き込まれる
+///
+///  @note データ配置はCL_LAYOUT_LINEARのみ
+///
+template<typename RECORD>
+class CutCellArrayTemplate : public CutInfoArray {
+
+  typedef typename RECORD::PosType CUT_POS;
+  typedef typename RECORD::BidType CUT_BID;
+
+public:
+  /// 交点座標配列ビュー.
+  class PosView : public CutPosArray {
+    RECORD* data;  ///< レコード配列
+
+  public:
+    /// コンストラクタ.
+    ///
+    ///  @param[in] a 対象領域(レコード配列)
+    ///  @param[in] data レコード配列
+    ///
+    PosView(const CutInfoArray& a, RECORD* data)
+      : CutPosArray(a.getStartX(), a.getStartY(), a.getStartZ(),
+                    a.getStartX() + (int)a.getSizeX() - 1,
+                    a.getStartY() + (int)a.getSizeY() - 1,
+                    a.getStartZ() + (int)a.getSizeZ() - 1),
+        data(data) {}
+
+    /// 一要素(1レコード)のバイトサイズを得る.
+    size_t getElementSize() const { return sizeof(RECORD); }
+
+    /// 交点座標値を設定(d方向).
+    void setPos(int i, int j, int k, int d, float pos) {
+      SetCutPos(data[getIndex(i,j,k)].pos, d, pos);
+    }
+
+    /// 交点座標値を設定(6方向まとめて).
+    void setPos(int i, int j, int k, const float pos[]) {
+      SetCutPos(data[getIndex(i,j,k)].pos, pos);
+    }
+
+    /// 交点座標値(d方向)を得る.
+    float getPos(int i, int j, int k, int d) const {
+      return GetCutPos(data[getIndex(i,j,k)].pos, d);
+    }
+
+    /// 交点座標値(d方向)を得る(1次元インデックスで指定).
+    float getPos(size_t ijk, int d) const { return GetCutPos(data[ijk].pos, d); }
+
+    /// 交点座標値(6方向まとめて)を得る.
+    void getPos(int i, int j, int k, float pos[]) const {
+      GetCutPos(data[getIndex(i,j,k)].pos, pos);
+    }
+
+    /// 交点座標値(6方向まとめて)を得る(1次元インデックスで指定).
+    void getPos(size_t ijk, float pos[]) const { GetCutPos(data[ijk].pos, pos); }
+
+    /// 全レコードの交点座標を1.0でクリア.
+    void clear() {
+      long nl = (long)getStorageSize();
+#pragma omp parallel for schedule(static)
+      for (long l = 0; l < nl; l++) ClearCutPos(data[l].pos);
+    }
+  };
+
+  /// 境界ID配列ビュー.
+  class BidView : public CutBidArray {
+    RECORD* data;  ///< レコード配列
+
+  public:
+    /// コンストラクタ.
+    ///
+    ///  @param[in] a 対象領域(レコード配列)
+    ///  @param[in] data レコード配列
+    ///
+    BidView(const CutInfoArray& a, RECORD* data)
+      : CutBidArray(a.getStartX(), a.getStartY(), a.getStartZ(),
+                    a.getStartX() + (int)a.getSizeX() - 1,
+                    a.getStartY() + (int)a.getSizeY() - 1,
+                    a.getStartZ() + (int)a.getSizeZ() - 1),
+        data(data) {}
+
+    /// 一要素(1レコード)のバイトサイズを得る.
+    size_t getElementSize() const { return sizeof(RECORD); }
+
+    /// 境界IDを設定(d方向).
+    void setBid(int i, int j, int k, int d, cutlib::BidType bid) {
+      SetCutBid(data[getIndex(i,j,k)].bid, d, bid);
+    }
+
+    /// 境界IDを設定(6方向まとめて).
+    void setBid(int i, int j, int k, const cutlib::BidType bid[]) {
+      SetCutBid(data[getIndex(i,j,k)].bid, bid);
+    }
+
+    /// 境界ID(d方向)を得る.
+    cutlib::BidType getBid(int i, int j, int k, int d) const {
+      return GetCutBid(data[getIndex(i,j,k)].bid, d);
+    }
+
+    /// 境界ID(d方向)を得る(1次元インデックスで指定).
+    cutlib::BidType getBid(size_t ijk, int d) const {
+      return GetCutBid(data[ijk].bid, d);
+    }
+
+    /// 境界ID(6方向まとめて)を得る.
+    void getBid(int i, int j, int k, cutlib::BidType bid[]) const {
+      GetCutBid(data[getIndex(i,j,k)].bid, bid);
+    }
+
+    /// 境界ID(6方向まとめて)を得る(1次元インデックスで指定).
+    void getBid(size_t ijk, cutlib::BidType bid[]) const {
+      GetCutBid(data[ijk].bid, bid);
+    }
+
+    /// 全レコードの境界IDを0クリア.
+    void clear() {
+      long nl = (long)getStorageSize();
+#pragma omp parallel for schedule(static)
+      for (long l = 0; l < nl; l++) ClearCutBid(data[l].bid);
+    }
+  };
+
+private:
+  size_t n;         ///< レコード数
+  RECORD* data;     ///< レコード配列
+  CutAllocator* allocator;           ///< メモリアロケータ
+  CutAlignedAllocator alignedAllocator;  ///< デフォルトのメモリアロケータ(64バイト境界)
+  PosView* posView;  ///< 交点座標配列ビュー
+  BidView* bidView;  ///< 境界ID配列ビュー
+
+  /// レコード配列を確保し，クリア.
+  void init() {
+    n = getStorageSize();
+    if (!allocator) allocator = &alignedAllocator;
+    data = static_cast<RECORD*>(allocator->allocate(n * sizeof(RECORD)));
+    clear();
+    posView = new PosView(*this, data);
+    bidView = new BidView(*this, data);
+  }
+
+public:
+  /// コンストラクタ.
+  ///
+  ///  @param[in] nx,ny,nz  配列サイズ(3次元で指定)
+  ///  @param[in] allocator メモリアロケータ(0の時は64バイト境界で確保)
+  ///
+  CutCellArrayTemplate(size_t nx, size_t ny, size_t nz, CutAllocator* allocator = 0)
+    : CutInfoArray(nx, ny, nz), allocator(allocator)
+  {
+    init();
+  }
+
+  /// コンストラクタ.
+  ///
+  ///  @param[in] sx,sy,sz 領域開始位置3次元インデクス
+  ///  @param[in] ex,ey,ez 領域終了位置3次元インデクス
+  ///  @param[in] allocator メモリアロケータ(0の時は64バイト境界で確保)
+  ///
+  CutCellArrayTemplate(int sx, int sy, int sz, int ex, int ey, int ez,
+                       CutAllocator* allocator = 0)
+    : CutInfoArray(sx, sy, sz, ex, ey, ez), allocator(allocator)
+  {
+    init();
+  }
+
+  /// コンストラクタ.
+  ///
+  ///  @param[in] ndim  配列サイズ(3次元で指定)
+  ///  @param[in] allocator メモリアロケータ(0の時は64バイト境界で確保)
+  ///
+  CutCellArrayTemplate(const size_t ndim[], CutAllocator* allocator = 0)
+    : CutInfoArray(ndim[0], ndim[1], ndim[2]), allocator(allocator)
+  {
+    init();
+  }
+
+  /// デストラクタ.
+  ~CutCellArrayTemplate() {
+    delete posView;
+    delete bidView;
+    allocator->deallocate(data, n * sizeof(RECORD));
+  }
+
+  /// 一要素(1レコード)のバイトサイズを得る.
+  size_t getElementSize() const { return sizeof(RECORD); }
+
+  /// 交点座標配列ビューを得る(CalcCutInfoに渡す).
+  CutPosArray* getPosArray() const { return posView; }
+
+  /// 境界ID配列ビューを得る(CalcCutInfoに渡す).
+  CutBidArray* getBidArray() const { return bidView; }
+
+  /// レコードを得る.
+  const RECORD& getRecord(int i, int j, int k) const { return data[getIndex(i,j,k)]; }
+
+  /// レコードを得る(1次元インデックスで指定).
+  const RECORD& getRecord(size_t ijk) const { return data[ijk]; }
+
+  /// レコード配列へのポインタを得る.
+  RECORD* getDataPointer() const { return data; }
+
+  /// レコード数を得る.
+  size_t getDataSize() const { return n; }
+
+  /// 法線ベクトルデータ格納位置をレコードに取り込む.
+  ///
+  ///  CalcCutInfo終了後に，同じ領域の法線ベクトル格納クラスから複写する
+  ///
+  ///  @param[in] cutNormal 法線ベクトル格納クラス
+  ///  @return 領域(始点,サイズ,レイアウト)が一致しない時,
+  ///          格納位置がレコードの範囲に収まらない時はfalse
+  ///
+  ///  @note 法線ベクトルデータ格納位置を持つレコード型でのみ使用可能
+  ///
+  bool setNormalIndex(const CutNormalArray* cutNormal) {
+    if (cutNormal->getStartX() != getStartX() ||
+        cutNormal->getStartY() != getStartY() ||
+        cutNormal->getStartZ() != getStartZ() ||
+        cutNormal->getSizeX() != getSizeX() ||
+        cutNormal->getSizeY() != getSizeY() ||
+        cutNormal->getSizeZ() != getSizeZ() ||
+        cutNormal->getLayout() != getLayout()) return false;
+    if (cutNormal->getNumNormal() >= (int)RECORD::NoNormal) return false;
+    long nl = (long)n;
+#pragma omp parallel for schedule(static)
+    for (long l = 0; l < nl; l++) {
+      for (int d = 0; d < 6; d++) {
+        SetCellNormal(data[l], d, cutNormal->getNormalIndex(l, d));
+      }
+    }
+    return true;
+  }
+
+  /// 法線ベクトルデータ格納位置を得る(交点なしの時は-1).
+  ///
+  ///  @note 法線ベクトルデータ格納位置を持つレコード型でのみ使用可能
+  ///
+  int getNormalIndex(int i, int j, int k, int d) const {
+    return GetCellNormal(data[getIndex(i,j,k)], d);
+  }
+
+  /// 全レコードをクリア.
+  void clear() {
+    long nl = (long)n;
+#pragma omp parallel for schedule(static)
+    for (long l = 0; l < nl; l++) ClearCellRecord(data[l]);
+  }
+
+private:
+  /// コピーコンストラクタ(使用禁止).
+  CutCellArrayTemplate(const CutCellArrayTemplate&);
+
+  /// 代入演算子(使用禁止).
+  CutCellArrayTemplate& operator=(const CutCellArrayTemplate&);
+
+};
+
+//-----------------------------------------------------------------------------
+
+/// CutPos8,CutBid8の16バイトレコード配列クラス.
+typedef CutCellArrayTemplate<CutCellRecord<CutPos8, CutBid8> > CutCell16Array;
+
+/// CutPos16,CutBid8,16ビット法線ベクトルデータ格納位置の32バイトレコード配列クラス.
+typedef CutCellArrayTemplate<CutCellNormalRecord<CutPos16, CutBid8> > CutCell32Array;
+
+//@} end group CutCellArray
+
+} // namespace cutlib
+
+#endif // CUTINFO_CELL_ARRAY_H
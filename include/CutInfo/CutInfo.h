@@ -48,6 +48,12 @@ typedef float   CutPos32[6];
 /// 交点座標基本型: 交点座標を8ビット量子化して，3つずつ，2つの32ビット整数に格納
 typedef int32_t CutPos8[2];
 
+/// 交点座標基本型: 交点座標を16ビット量子化(四捨五入)して，6つの16ビット整数に格納
+typedef uint16_t CutPos16[6];
+
+/// 交点座標基本型: 交点座標を10ビット量子化(四捨五入)して，3つずつ，2つの32ビット符号なし整数に格納
+typedef uint32_t CutPos10[2];
+
 /// 境界ID基本型: 0〜255の境界ID(8ビット)を3つずつ，2つの32ビット整数に格納
 typedef int32_t CutBid8[2];
 
@@ -188,6 +194,141 @@ inline void GetCutPos(const CutPos8& cp, float pos[])
 
 //-----------------------------------------------------------------------------
 
+/// 交点座標値を1.0でクリア
+/**
+ * @param[out] cp 交点座標基本型
+ */
+inline void ClearCutPos(CutPos16& cp)
+{
+  for (int d = 0; d < 6; d++) cp[d] = 65535;
+}
+
+/// 交点座標値を設定(d方向)
+/**
+ * @param[out] cp 交点座標基本型
+ * @param[in] d 交点探査方向(0〜5)
+ * @param[in] pos 交点座標値
+ */
+inline void SetCutPos(CutPos16& cp, int d, float pos)
+{
+  cp[d] = (uint16_t)(pos*65535 + 0.5f);
+}
+
+/// 交点座標値を設定(6方向まとめて)
+/**
+ * @param[out] cp 交点座標基本型
+ * @param[in] pos 交点座標値配列
+ */
+inline void SetCutPos(CutPos16& cp, const float pos[])
+{
+  for (int d = 0; d < 6; d++) cp[d] = (uint16_t)(pos[d]*65535 + 0.5f);
+}
+
+/// 交点座標値(d方向)を得る
+/**
+ * @param[in] cp 交点座標基本型
+ * @param[in] d 交点探査方向(0〜5)
+ * @return 交点座標値
+ */
+inline float GetCutPos(const CutPos16& cp, int d)
+{
+  return (float)cp[d] / 65535;
+}
+
+/// 交点座標値(6方向まとめて)を得る
+/**
+ * @param[in] cp 交点座標基本型
+ * @param[out] pos 交点座標値配列
+ */
+inline void GetCutPos(const CutPos16& cp, float pos[])
+{
+  for (int d = 0; d < 6; d++) pos[d] = (float)cp[d] / 65535;
+}
+
+//-----------------------------------------------------------------------------
+
+/// クリアマスク(方向別)
+const uint32_t CutPos10Clear0[3] = {
+   ~(uint32_t)1023,
+   ~((uint32_t)1023 << 10),
+   ~((uint32_t)1023 << 20)
+};
+
+/// クリアマスク(6方向まとめて)
+const uint32_t CutPos10Clear = (uint32_t)1023 | ((uint32_t)1023<<10) | ((uint32_t)1023<<20);
+
+/// 交点座標値を10ビット量子化(四捨五入)
+inline uint32_t QuantizeCutPos10(float pos)
+{
+  return (uint32_t)(pos*1023 + 0.5f);
+}
+
+/// 交点座標値を1.0でクリア
+/**
+ * @param[out] cp 交点座標基本型
+ */
+inline void ClearCutPos(CutPos10& cp)
+{
+  cp[0] = cp[1] = CutPos10Clear;
+}
+
+/// 交点座標値を設定(d方向)
+/**
+ * @param[out] cp 交点座標基本型
+ * @param[in] d 交点探査方向(0〜5)
+ * @param[in] pos 交点座標値
+ */
+inline void SetCutPos(CutPos10& cp, int d, float pos)
+{
+  int i =  (d < 3) ? 0 : 1;
+  cp[i] &= CutPos10Clear0[d%3];
+  cp[i] |= QuantizeCutPos10(pos) << (d%3)*10;
+}
+
+/// 交点座標値を設定(6方向まとめて)
+/**
+ * @param[out] cp 交点座標基本型
+ * @param[in] pos 交点座標値配列
+ */
+inline void SetCutPos(CutPos10& cp, const float pos[])
+{
+  cp[0] = QuantizeCutPos10(pos[0])
+        | (QuantizeCutPos10(pos[1]) << 10)
+        | (QuantizeCutPos10(pos[2]) << 20);
+  cp[1] = QuantizeCutPos10(pos[3])
+        | (QuantizeCutPos10(pos[4]) << 10)
+        | (QuantizeCutPos10(pos[5]) << 20);
+}
+
+/// 交点座標値(d方向)を得る
+/**
+ * @param[in] cp 交点座標基本型
+ * @param[in] d 交点探査方向(0〜5)
+ * @return 交点座標値
+ */
+inline float GetCutPos(const CutPos10& cp, int d)
+{
+  int i =  (d < 3) ? 0 : 1;
+  return (float)((cp[i] >> (d%3)*10) & 1023) / 1023;
+}
+
+/// 交点座標値(6方向まとめて)を得る
+/**
+ * @param[in] cp 交点座標基本型
+ * @param[out] pos 交点座標値配列
+ */
+inline void GetCutPos(const CutPos10& cp, float pos[])
+{
+  for (int i = 0; i < 2; i++) {
+    uint32_t qpos3 = cp[i];
+    pos[3*i  ] = (float)(qpos3 & 1023) / 1023; qpos3 >>= 10;
+    pos[3*i+1] = (float)(qpos3 & 1023) / 1023; qpos3 >>= 10;
+    pos[3*i+2] = (float)(qpos3 & 1023) / 1023;
+  }
+}
+
+//-----------------------------------------------------------------------------
+
 /// クリアマスク(方向別)
 const int32_t CutBid8Clear0[3] = {
    ~(int32_t)255,
@@ -383,6 +524,159 @@ inline void GetCutBid(const CUT_BID* cb, size_t ijk, BidType bid[])
   GetCutBid(cb[ijk], bid);
 }
 
+//-----------------------------------------------------------------------------
+
+/// 交点座標値配列を一括して交点座標基本型配列に格納
+/**
+ * @param[out] cp 交点座標基本型配列
+ * @param[in] pos 交点座標値配列(1要素6方向, n要素)
+ * @param[in] n 要素数
+ */
+template<typename CUT_POS>
+inline void EncodeCutPos(CUT_POS* cp, const float* pos, size_t n)
+{
+  for (size_t i = 0; i < n; i++) SetCutPos(cp[i], &pos[6*i]);
+}
+
+/// 交点座標基本型配列から交点座標値を一括して得る
+/**
+ * @param[in] cp 交点座標基本型配列
+ * @param[out] pos 交点座標値配列(1要素6方向, n要素)
+ * @param[in] n 要素数
+ */
+template<typename CUT_POS>
+inline void DecodeCutPos(const CUT_POS* cp, float* pos, size_t n)
+{
+  for (size_t i = 0; i < n; i++) GetCutPos(cp[i], &pos[6*i]);
+}
+
+/// 交点座標値配列を一括して交点座標基本型配列に格納(CutPos16)
+/**
+ *  要素の区切りのない単純ループとしてコンパイラのSIMD化を可能にする
+ *
+ * @param[out] cp 交点座標基本型配列
+ * @param[in] pos 交点座標値配列(1要素6方向, n要素)
+ * @param[in] n 要素数
+ */
+inline void EncodeCutPos(CutPos16* cp, const float* pos, size_t n)
+{
+  uint16_t* q = &cp[0][0];
+  for (size_t l = 0; l < 6*n; l++) q[l] = (uint16_t)(pos[l]*65535 + 0.5f);
+}
+
+/// 交点座標基本型配列から交点座標値を一括して得る(CutPos16)
+/**
+ *  要素の区切りのない単純ループとしてコンパイラのSIMD化を可能にする
+ *
+ * @param[in] cp 交点座標基本型配列
+ * @param[out] pos 交点座標値配列(1要素6方向, n要素)
+ * @param[in] n 要素数
+ */
+inline void DecodeCutPos(const CutPos16* cp, float* pos, size_t n)
+{
+  const uint16_t* q = &cp[0][0];
+  for (size_t l = 0; l < 6*n; l++) pos[l] = (float)q[l] / 65535;
+}
+
+/// 交点座標基本型配列から交点座標値を一括して得る(CutPos8)
+/**
+ *  32ビット整数毎の単純ループとしてコンパイラのSIMD化を可能にする
+ *
+ * @param[in] cp 交点座標基本型配列
+ * @param[out] pos 交点座標値配列(1要素6方向, n要素)
+ * @param[in] n 要素数
+ */
+inline void DecodeCutPos(const CutPos8* cp, float* pos, size_t n)
+{
+  const int32_t* q = &cp[0][0];
+  for (size_t l = 0; l < 2*n; l++) {
+    pos[3*l  ] = (float)( q[l]        & 255) / 255;
+    pos[3*l+1] = (float)((q[l] >> 8)  & 255) / 255;
+    pos[3*l+2] = (float)((q[l] >> 16) & 255) / 255;
+  }
+}
+
+/// 交点座標値配列を一括して交点座標基本型配列に格納(CutPos10)
+/**
+ *  32ビット整数毎の単純ループとしてコンパイラのSIMD化を可能にする
+ *
+ * @param[out] cp 交点座標基本型配列
+ * @param[in] pos 交点座標値配列(1要素6方向, n要素)
+ * @param[in] n 要素数
+ */
+inline void EncodeCutPos(CutPos10* cp, const float* pos, size_t n)
+{
+  uint32_t* q = &cp[0][0];
+  for (size_t l = 0; l < 2*n; l++) {
+    q[l] = QuantizeCutPos10(pos[3*l])
+         | (QuantizeCutPos10(pos[3*l+1]) << 10)
+         | (QuantizeCutPos10(pos[3*l+2]) << 20);
+  }
+}
+
+/// 交点座標基本型配列から交点座標値を一括して得る(CutPos10)
+/**
+ *  32ビット整数毎の単純ループとしてコンパイラのSIMD化を可能にする
+ *
+ * @param[in] cp 交点座標基本型配列
+ * @param[out] pos 交点座標値配列(1要素6方向, n要素)
+ * @param[in] n 要素数
+ */
+inline void DecodeCutPos(const CutPos10* cp, float* pos, size_t n)
+{
+  const uint32_t* q = &cp[0][0];
+  for (size_t l = 0; l < 2*n; l++) {
+    pos[3*l  ] = (float)( q[l]        & 1023) / 1023;
+    pos[3*l+1] = (float)((q[l] >> 10) & 1023) / 1023;
+    pos[3*l+2] = (float)((q[l] >> 20) & 1023) / 1023;
+  }
+}
+
+/// 境界ID基本型配列から境界IDを一括して得る
+/**
+ * @param[in] cb 境界ID基本型配列
+ * @param[out] bid 境界ID配列(1要素6方向, n要素)
+ * @param[in] n 要素数
+ */
+template<typename CUT_BID>
+inline void DecodeCutBid(const CUT_BID* cb, BidType* bid, size_t n)
+{
+  for (size_t i = 0; i < n; i++) GetCutBid(cb[i], &bid[6*i]);
+}
+
+/// 境界ID基本型配列から境界IDを一括して得る(CutBid8)
+/**
+ *  32ビット整数毎の単純ループとしてコンパイラのSIMD化を可能にする
+ *
+ * @param[in] cb 境界ID基本型配列
+ * @param[out] bid 境界ID配列(1要素6方向, n要素)
+ * @param[in] n 要素数
+ */
+inline void DecodeCutBid(const CutBid8* cb, BidType* bid, size_t n)
+{
+  const int32_t* q = &cb[0][0];
+  for (size_t l = 0; l < 2*n; l++) {
+    bid[3*l  ] = (BidType)( q[l]        & 255);
+    bid[3*l+1] = (BidType)((q[l] >> 8)  & 255);
+    bid[3*l+2] = (BidType)((q[l] >> 16) & 255);
+  }
+}
+
+/// 境界ID基本型配列から境界IDを一括して得る(CutBid5)
+/**
+ *  32ビット整数毎の単純ループとしてコンパイラのSIMD化を可能にする
+ *
+ * @param[in] cb 境界ID基本型配列
+ * @param[out] bid 境界ID配列(1要素6方向, n要素)
+ * @param[in] n 要素数
+ */
+inline void DecodeCutBid(const CutBid5* cb, BidType* bid, size_t n)
+{
+  for (size_t l = 0; l < n; l++) {
+    for (int d = 0; d < 6; d++) bid[6*l+d] = (BidType)((cb[l] >> d*5) & 31);
+  }
+}
+
 //@} end gropu CutInfo
 
 } // namespace cutlib
@@ -23,12 +23,21 @@
 #define CUTINFO_ARRAY_H
 
 #include "CutInfo.h"
+#include "CutAllocator.h"
 
 namespace cutlib {
 
 /// @defgroup CutInfoArray 交点情報一次元配列ラッパクラス
 //@{
 
+/// 一次元配列のデータ配置.
+enum CutInfoLayout {
+  CL_LAYOUT_LINEAR = 0,  ///< i方向最速の辞書式順(デフォルト)
+  CL_LAYOUT_TILED  = 1,  ///< タイル単位(タイル内,タイル間とも辞書式順)
+  CL_LAYOUT_MORTON = 2   ///< タイル単位(タイル内はMorton順,タイル間は辞書式順)
+};
+
+
 /// 一次元配列ラッパクラスの基底クラス
 class CutInfoArray {
 
@@ -40,13 +49,27 @@ class CutInfoArray {
   size_t ny;  ///< y方向対象領域サイズ
   size_t nz;  ///< z方向対象領域サイズ
 
+  CutInfoLayout layout;  ///< データ配置
+  size_t ntx;  ///< x方向タイル数
+  size_t nty;  ///< y方向タイル数
+  size_t ntz;  ///< z方向タイル数
+
 public:
+  /// タイルの一辺のセル数(CL_LAYOUT_TILED, CL_LAYOUT_MORTON).
+  ///
+  ///  CalcCutInfoのブリックサイズ(CutOccupancy::DefaultBrickSize)と同じ
+  ///
+  static const int TileSize = 8;
+
   /// コンストラクタ.
   ///
   ///   @param[in] nx,ny,nz 配列サイズ(3次元で指定)
   ///
   CutInfoArray(size_t nx, size_t ny, size_t nz)
-    : sx(0), sy(0), sz(0), nx(nx), ny(ny), nz(nz) {}
+    : sx(0), sy(0), sz(0), nx(nx), ny(ny), nz(nz)
+  {
+    setIndexLayout(CL_LAYOUT_LINEAR);
+  }
 
   /// コンストラクタ.
   ///
@@ -54,7 +77,10 @@ public:
   ///   @param[in] ex,ey,ez 領域終了位置3次元インデクス
   ///
   CutInfoArray(int sx, int sy, int sz, int ex, int ey, int ez)
-    : sx(sx), sy(sy), sz(sz), nx(ex-sx+1), ny(ey-sy+1), nz(ez-sz+1) {}
+    : sx(sx), sy(sy), sz(sz), nx(ex-sx+1), ny(ey-sy+1), nz(ez-sz+1)
+  {
+    setIndexLayout(CL_LAYOUT_LINEAR);
+  }
 
   /// デストラクタ.
   virtual ~CutInfoArray() {}
@@ -80,12 +106,86 @@ public:
   /// z方向の開始位置を得る.
   int getStartZ() const { return sz; }
 
+  /// 開始位置を変更(配列サイズ,データは変更しない).
+  ///
+  ///  同じデータ領域を別の領域(スラブ等)の格納に再利用する時に使用する
+  ///
+  ///  @param[in] sx,sy,sz 領域開始位置3次元インデクス
+  ///
+  void setStart(int sx, int sy, int sz) {
+    this->sx = sx;
+    this->sy = sy;
+    this->sz = sz;
+  }
+
   /// 3次元インデックス(i,j,k)より1次元インデックスを計算
   ///
   ///  @param[in] i,j,k  3次元インデックス
   ///
+  ///  @note CL_LAYOUT_LINEAR以外では(sx,sy,sz)を原点とするタイル単位の配置
+  ///
   size_t getIndex(int i, int j, int k) const {
-    return (i-sx) + (j-sy) * nx + (k-sz) * nx * ny;
+    size_t li = i - sx;
+    size_t lj = j - sy;
+    size_t lk = k - sz;
+    if (layout == CL_LAYOUT_LINEAR) return li + lj * nx + lk * nx * ny;
+
+    size_t tile = (li / TileSize) + (lj / TileSize) * ntx
+                + (lk / TileSize) * ntx * nty;
+    size_t local;
+    if (layout == CL_LAYOUT_MORTON) {
+      local = MortonEncode(li % TileSize, lj % TileSize, lk % TileSize);
+    } else {
+      local = (li % TileSize) + (lj % TileSize) * TileSize
+            + (lk % TileSize) * TileSize * TileSize;
+    }
+    return tile * TileSize * TileSize * TileSize + local;
+  }
+
+  /// データ配置を得る.
+  CutInfoLayout getLayout() const { return layout; }
+
+  /// データ配置に必要な一次元データサイズを得る.
+  ///
+  ///  CL_LAYOUT_LINEAR以外では各方向をTileSizeの倍数に切り上げたサイズ
+  ///
+  size_t getStorageSize() const {
+    if (layout == CL_LAYOUT_LINEAR) return nx * ny * nz;
+    return ntx * nty * ntz * TileSize * TileSize * TileSize;
+  }
+
+  /// タイル内座標(0〜7)からMorton順の位置を計算.
+  ///
+  ///  @param[in] x,y,z タイル内3次元インデクス
+  ///  @return タイル内Morton順位置(0〜511)
+  ///
+  static size_t MortonEncode(size_t x, size_t y, size_t z) {
+    // 3ビットの各ビットを3ビット間隔に展開
+    static const size_t spread[8] = { 0, 1, 8, 9, 64, 65, 72, 73 };
+    return spread[x] | (spread[y] << 1) | (spread[z] << 2);
+  }
+
+  /// タイル内Morton順の位置からタイル内座標を計算.
+  ///
+  ///  @param[in] m タイル内Morton順位置(0〜511)
+  ///  @param[out] x,y,z タイル内3次元インデクス
+  ///
+  static void MortonDecode(size_t m, int& x, int& y, int& z) {
+    x = (int)(( m       & 1) | ((m >> 2) & 2) | ((m >> 4) & 4));
+    y = (int)(((m >> 1) & 1) | ((m >> 3) & 2) | ((m >> 5) & 4));
+    z = (int)(((m >> 2) & 1) | ((m >> 4) & 2) | ((m >> 6) & 4));
+  }
+
+protected:
+  /// インデクス計算のデータ配置を設定(データ領域は変更しない).
+  ///
+  ///  @param[in] layout データ配置
+  ///
+  void setIndexLayout(CutInfoLayout layout) {
+    this->layout = layout;
+    ntx = (nx + TileSize - 1) / TileSize;
+    nty = (ny + TileSize - 1) / TileSize;
+    ntz = (nz + TileSize - 1) / TileSize;
   }
 };
 
@@ -155,6 +255,39 @@ public:
   ///
   virtual void getPos(size_t ijk, float pos[]) const = 0;
 
+  /// 交点座標値(6方向まとめて)をx方向の範囲で得る.
+  ///
+  ///  @param[in] i0,i1 x方向インデクス範囲(i0 <= i < i1)
+  ///  @param[in] j,k   y,z方向インデクス
+  ///  @param[out] pos  交点座標配列(6*(i1-i0)要素, セル毎に6方向)
+  ///
+  ///  @note 派生クラスでは一次元データを直接一括変換する版で置き換える
+  ///
+  virtual void getPosRange(int i0, int i1, int j, int k, float pos[]) const
+  {
+    for (int i = i0; i < i1; i++) getPos(i, j, k, &pos[6*(i-i0)]);
+  }
+
+  /// 交点座標値(6方向まとめて)をz方向のスラブ単位で得る.
+  ///
+  ///  x,y方向は配列の全範囲
+  ///
+  ///  @param[in] k0,k1 z方向インデクス範囲(k0 <= k < k1)
+  ///  @param[out] pos  交点座標配列(6*getSizeX()*getSizeY()*(k1-k0)要素, i方向最速)
+  ///
+  void getPosSlab(int k0, int k1, float pos[]) const
+  {
+    int i0 = getStartX();
+    int i1 = i0 + (int)getSizeX();
+    size_t row = 6 * getSizeX();
+    for (int k = k0; k < k1; k++) {
+      for (size_t j = 0; j < getSizeY(); j++) {
+        getPosRange(i0, i1, getStartY() + (int)j, k, pos);
+        pos += row;
+      }
+    }
+  }
+
   /// 全配列データを1.0でクリア
   virtual void clear() = 0;
 };
@@ -225,6 +358,39 @@ public:
   ///
   virtual void getBid(size_t ijk, BidType bid[]) const = 0;
 
+  /// 境界ID(6方向まとめて)をx方向の範囲で得る.
+  ///
+  ///  @param[in] i0,i1 x方向インデクス範囲(i0 <= i < i1)
+  ///  @param[in] j,k   y,z方向インデクス
+  ///  @param[out] bid  境界ID配列(6*(i1-i0)要素, セル毎に6方向)
+  ///
+  ///  @note 派生クラスでは一次元データを直接一括変換する版で置き換える
+  ///
+  virtual void getBidRange(int i0, int i1, int j, int k, BidType bid[]) const
+  {
+    for (int i = i0; i < i1; i++) getBid(i, j, k, &bid[6*(i-i0)]);
+  }
+
+  /// 境界ID(6方向まとめて)をz方向のスラブ単位で得る.
+  ///
+  ///  x,y方向は配列の全範囲
+  ///
+  ///  @param[in] k0,k1 z方向インデクス範囲(k0 <= k < k1)
+  ///  @param[out] bid  境界ID配列(6*getSizeX()*getSizeY()*(k1-k0)要素, i方向最速)
+  ///
+  void getBidSlab(int k0, int k1, BidType bid[]) const
+  {
+    int i0 = getStartX();
+    int i1 = i0 + (int)getSizeX();
+    size_t row = 6 * getSizeX();
+    for (int k = k0; k < k1; k++) {
+      for (size_t j = 0; j < getSizeY(); j++) {
+        getBidRange(i0, i1, getStartY() + (int)j, k, bid);
+        bid += row;
+      }
+    }
+  }
+
   /// 全配列データを0クリア.
   virtual void clear() = 0;
 };
@@ -237,19 +403,41 @@ class CutPosArrayTemplate : public CutPosArray {
   size_t n;        ///< 一次元データサイズ
   CUT_POS* data;   ///< 一次元データポインタ
   bool allocated;  ///< 一次元データ管理フラグ
+  CutAllocator* allocator;  ///< メモリアロケータ(0の時はnew[]/delete[])
+
+  /// 一次元データ領域を確保(要素の初期化は行わない).
+  CUT_POS* allocateData() const
+  {
+    if (allocator) {
+      return static_cast<CUT_POS*>(allocator->allocate(n * sizeof(CUT_POS)));
+    }
+    return new CUT_POS[n];
+  }
+
+  /// 一次元データ領域を解放.
+  void deallocateData()
+  {
+    if (allocator) {
+      allocator->deallocate(data, n * sizeof(CUT_POS));
+    } else {
+      delete[] data;
+    }
+  }
 
 public:
   /// コンストラクタ(自前で一次元データ領域を確保).
   ///
   ///  @param[in] nx,ny,nz  配列サイズ(3次元で指定)
+  ///  @param[in] allocator メモリアロケータ(0の時はnew[]で確保)
   ///
   ///  @note デストラクタで一次元データ領域を開放(allocated_=true)
   ///
-  CutPosArrayTemplate(size_t nx, size_t ny, size_t nz) : CutPosArray(nx, ny, nz)
+  CutPosArrayTemplate(size_t nx, size_t ny, size_t nz, CutAllocator* allocator = 0)
+    : CutPosArray(nx, ny, nz), allocator(allocator)
   {
     n = nx * ny * nz;
-    data = new CUT_POS[n];
-    for (size_t ijk = 0; ijk < n; ijk++) ClearCutPos(data[ijk]);
+    data = allocateData();
+    ClearData(data, n);
     allocated = true;
   }
 
@@ -257,29 +445,33 @@ public:
   ///
   ///  @param[in] sx,sy,sz 領域開始位置3次元インデクス
   ///  @param[in] ex,ey,ez 領域終了位置3次元インデクス
+  ///  @param[in] allocator メモリアロケータ(0の時はnew[]で確保)
   ///
   ///  @note デストラクタで一次元データ領域を開放(allocated_=true)
   ///
-  CutPosArrayTemplate(int sx, int sy, int sz, int ex, int ey, int ez)
-    : CutPosArray(sx, sy, sz, ex, ey, ez)
+  CutPosArrayTemplate(int sx, int sy, int sz, int ex, int ey, int ez,
+                      CutAllocator* allocator = 0)
+    : CutPosArray(sx, sy, sz, ex, ey, ez), allocator(allocator)
   {
     n = (ex-sx+1) * (ey-sy+1) * (ez-sz+1);
-    data = new CUT_POS[n];
-    for (size_t ijk = 0; ijk < n; ijk++) ClearCutPos(data[ijk]);
+    data = allocateData();
+    ClearData(data, n);
     allocated = true;
   }
 
   /// コンストラクタ(自前で一次元データ領域を確保).
   ///
   ///  @param[in] ndim  配列サイズ(3次元で指定)
+  ///  @param[in] allocator メモリアロケータ(0の時はnew[]で確保)
   ///
   ///  @note デストラクタで一次元データ領域を開放(allocated_=true)
   ///
-  CutPosArrayTemplate(const size_t ndim[]) : CutPosArray(ndim[0], ndim[1], ndim[2])
+  CutPosArrayTemplate(const size_t ndim[], CutAllocator* allocator = 0)
+    : CutPosArray(ndim[0], ndim[1], ndim[2]), allocator(allocator)
   {
     n = ndim[0] * ndim[1] * ndim[2];
-    data = new CUT_POS[n];
-    for (size_t ijk = 0; ijk < n; ijk++) ClearCutPos(data[ijk]);
+    data = allocateData();
+    ClearData(data, n);
     allocated = true;
   }
 
@@ -287,15 +479,17 @@ public:
   ///
   ///  @param[in] start 領域開始位置3次元インデクス
   ///  @param[in] end   領域終了位置3次元インデクス
+  ///  @param[in] allocator メモリアロケータ(0の時はnew[]で確保)
   ///
   ///  @note デストラクタで一次元データ領域を開放(allocated_=true)
   ///
-  CutPosArrayTemplate(int start[], int end[])
-    : CutPosArray(start[0], start[1], start[2], end[0], end[1], end[2])
+  CutPosArrayTemplate(int start[], int end[], CutAllocator* allocator = 0)
+    : CutPosArray(start[0], start[1], start[2], end[0], end[1], end[2]),
+      allocator(allocator)
   {
     n = (end[0]-start[0]+1) * (end[1]-start[1]+1) * (end[2]-start[2]+1);
-    data = new CUT_POS[n];
-    for (size_t ijk = 0; ijk < n; ijk++) ClearCutPos(data[ijk]);
+    data = allocateData();
+    ClearData(data, n);
     allocated = true;
   }
 
@@ -307,7 +501,7 @@ public:
   ///  @note デストラクタで一次元データ領域を開放しない(allocated_=false)
   ///
   CutPosArrayTemplate(CUT_POS* data, size_t nx, size_t ny, size_t nz)
-    : CutPosArray(nx, ny, nz), data(data)
+    : CutPosArray(nx, ny, nz), data(data), allocator(0)
   {
     n = nx * ny * nz;
     allocated = false;
@@ -322,7 +516,7 @@ public:
   ///  @note デストラクタで一次元データ領域を開放しない(allocated_=false)
   ///
   CutPosArrayTemplate(CUT_POS* data, int sx, int sy, int sz, int ex, int ey, int ez)
-    : CutPosArray(sx, sy, sz, ex, ey, ez), data(data)
+    : CutPosArray(sx, sy, sz, ex, ey, ez), data(data), allocator(0)
   {
     n = (ex-sx+1) * (ey-sy+1) * (ez-sz+1);
     allocated = false;
@@ -332,7 +526,10 @@ public:
   ///
   ///  @note allocated_=trueの場合のみ一次元データ領域を開放
   ///
-  ~CutPosArrayTemplate() { if (allocated) delete[] data; }
+  ~CutPosArrayTemplate()
+  {
+    if (allocated) deallocateData();
+  }
 
   /// 一要素のバイトサイズを得る.
   size_t getElementSize() const { return sizeof(CUT_POS); }
@@ -403,6 +600,41 @@ public:
     GetCutPos(data[ijk], pos);
   }
 
+  /// データ配置を変更.
+  ///
+  ///  自前で確保した領域は新しい配置に必要なサイズで確保し直し，1.0でクリアする.
+  ///  インポートした領域はインデクス計算のみ変更するので，
+  ///  呼び出し側でgetStorageSize()要素以上の領域を用意しておくこと
+  ///
+  ///  @param[in] layout データ配置
+  ///
+  void setLayout(CutInfoLayout layout)
+  {
+    if (allocated) deallocateData();
+    setIndexLayout(layout);
+    n = getStorageSize();
+    if (allocated) {
+      data = allocateData();
+      ClearData(data, n);
+    }
+  }
+
+  /// 交点座標値(6方向まとめて)をx方向の範囲で得る.
+  ///
+  ///  @param[in] i0,i1 x方向インデクス範囲(i0 <= i < i1)
+  ///  @param[in] j,k   y,z方向インデクス
+  ///  @param[out] pos  交点座標配列(6*(i1-i0)要素, セル毎に6方向)
+  ///
+  void getPosRange(int i0, int i1, int j, int k, float pos[]) const
+  {
+    if (i1 <= i0) return;
+    if (getLayout() == CL_LAYOUT_LINEAR) {
+      DecodeCutPos(data + getIndex(i0,j,k), pos, i1 - i0);
+    } else {
+      for (int i = i0; i < i1; i++) GetCutPos(data[getIndex(i,j,k)], &pos[6*(i-i0)]);
+    }
+  }
+
   /// 一次元配列データへのポインタを得る.
   CUT_POS* getDataPointer() const { return data; }
 
@@ -411,9 +643,41 @@ public:
   size_t getDataSize() const { return n; }
 
   /// 全配列データを1.0でクリア
-  void clear()
+  void clear() { ClearData(data, n); }
+
+  /// 3次元インデクス範囲の配列データを1.0でクリア.
+  ///
+  ///  CalcCutInfoはワークブロック毎にこれを呼び，各ページを
+  ///  そのワークブロックを探索するスレッドが最初に書き込む(first touch)
+  ///
+  ///  @param[in] s 開始3次元インデクス
+  ///  @param[in] e 終了3次元インデクスの次
+  ///
+  void clear(const int s[], const int e[])
   {
-    for (size_t i = 0; i < n; i++) ClearCutPos(data[i]);
+    for (int k = s[2]; k < e[2]; k++) {
+      for (int j = s[1]; j < e[1]; j++) {
+        for (int i = s[0]; i < e[0]; i++) ClearCutPos(data[getIndex(i,j,k)]);
+      }
+    }
+  }
+
+  /// 一次元データ領域を1.0でクリア(OpenMP並列).
+  ///
+  ///  new[]直後の領域に対して呼ぶと，各ページはk方向に連続した
+  ///  一次元インデクス区間を静的に割り当てられたスレッドが
+  ///  最初に書き込む(first touch)ため，そのスレッドのNUMAノードに配置される.
+  ///  CalcCutInfoは計算領域と配列領域が一致する時，
+  ///  clear(s, e)でワークブロック単位に書き込み直す
+  ///
+  ///  @param[out] data 一次元データポインタ
+  ///  @param[in] n 一次元データサイズ
+  ///
+  static void ClearData(CUT_POS* data, size_t n)
+  {
+    long nl = (long)n;
+#pragma omp parallel for schedule(static)
+    for (long i = 0; i < nl; i++) ClearCutPos(data[i]);
   }
 
 };
@@ -426,19 +690,41 @@ class CutBidArrayTemplate : public CutBidArray {
   size_t n;        ///< 一次元データサイズ
   CUT_BID* data;   ///< 一次元データポインタ
   bool allocated;  ///< 一次元データ管理フラグ
+  CutAllocator* allocator;  ///< メモリアロケータ(0の時はnew[]/delete[])
+
+  /// 一次元データ領域を確保(要素の初期化は行わない).
+  CUT_BID* allocateData() const
+  {
+    if (allocator) {
+      return static_cast<CUT_BID*>(allocator->allocate(n * sizeof(CUT_BID)));
+    }
+    return new CUT_BID[n];
+  }
+
+  /// 一次元データ領域を解放.
+  void deallocateData()
+  {
+    if (allocator) {
+      allocator->deallocate(data, n * sizeof(CUT_BID));
+    } else {
+      delete[] data;
+    }
+  }
 
 public:
   /// コンストラクタ(自前で一次元データ領域を確保).
   ///
   ///  @param[in] nx,ny,nz  配列サイズ(3次元で指定)
+  ///  @param[in] allocator メモリアロケータ(0の時はnew[]で確保)
   ///
   ///  @note デストラクタで一次元データ領域を開放(allocated_=true)
   ///
-  CutBidArrayTemplate(size_t nx, size_t ny, size_t nz) : CutBidArray(nx, ny, nz)
+  CutBidArrayTemplate(size_t nx, size_t ny, size_t nz, CutAllocator* allocator = 0)
+    : CutBidArray(nx, ny, nz), allocator(allocator)
   {
     n = nx * ny * nz;
-    data = new CUT_BID[n];
-    for (size_t ijk = 0; ijk < n; ijk++) ClearCutBid(data[ijk]);
+    data = allocateData();
+    ClearData(data, n);
     allocated = true;
   }
 
@@ -446,29 +732,33 @@ public:
   ///
   ///  @param[in] sx,sy,sz 領域開始位置3次元インデクス
   ///  @param[in] ex,ey,ez 領域終了位置3次元インデクス
+  ///  @param[in] allocator メモリアロケータ(0の時はnew[]で確保)
   ///
   ///  @note デストラクタで一次元データ領域を開放(allocated_=true)
   ///
-  CutBidArrayTemplate(int sx, int sy, int sz, int ex, int ey, int ez)
-    : CutBidArray(sx, sy, sz, ex, ey, ez)
+  CutBidArrayTemplate(int sx, int sy, int sz, int ex, int ey, int ez,
+                      CutAllocator* allocator = 0)
+    : CutBidArray(sx, sy, sz, ex, ey, ez), allocator(allocator)
   {
     n = (ex-sx+1) * (ey-sy+1) * (ez-sz+1);
-    data = new CUT_BID[n];
-    for (size_t ijk = 0; ijk < n; ijk++) ClearCutBid(data[ijk]);
+    data = allocateData();
+    ClearData(data, n);
     allocated = true;
   }
 
   /// コンストラクタ(自前で一次元データ領域を確保).
   ///
   ///@param[in] ndim  配列サイズ(3次元で指定)
+  ///  @param[in] allocator メモリアロケータ(0の時はnew[]で確保)
   ///
   ///  @note デストラクタで一次元データ領域を開放(allocated_=true)
   ///
-  CutBidArrayTemplate(const size_t ndim[]) : CutBidArray(ndim[0], ndim[1], ndim[2])
+  CutBidArrayTemplate(const size_t ndim[], CutAllocator* allocator = 0)
+    : CutBidArray(ndim[0], ndim[1], ndim[2]), allocator(allocator)
   {
     n = ndim[0] * ndim[1] * ndim[2];
-    data = new CUT_BID[n];
-    for (size_t ijk = 0; ijk < n; ijk++) ClearCutBid(data[ijk]);
+    data = allocateData();
+    ClearData(data, n);
     allocated = true;
   }
 
@@ -476,15 +766,17 @@ public:
   ///
   ///  @param[in] start 領域開始位置3次元インデクス
   ///  @param[in] end   領域終了位置3次元インデクス
+  ///  @param[in] allocator メモリアロケータ(0の時はnew[]で確保)
   ///
   ///  @note デストラクタで一次元データ領域を開放(allocated_=true)
   ///
-  CutBidArrayTemplate(int start[], int end[])
-    : CutBidArray(start[0], start[1], start[2], end[0], end[1], end[2])
+  CutBidArrayTemplate(int start[], int end[], CutAllocator* allocator = 0)
+    : CutBidArray(start[0], start[1], start[2], end[0], end[1], end[2]),
+      allocator(allocator)
   {
     n = (end[0]-start[0]+1) * (end[1]-start[1]+1) * (end[2]-start[2]+1);
-    data = new CUT_BID[n];
-    for (size_t ijk = 0; ijk < n; ijk++) ClearCutBid(data[ijk]);
+    data = allocateData();
+    ClearData(data, n);
     allocated = true;
   }
 
@@ -496,7 +788,7 @@ public:
   ///  @デストラクタで一次元データ領域を開放しない(allocated_=false)
   ///
   CutBidArrayTemplate(CUT_BID* data, size_t nx, size_t ny, size_t nz)
-    : CutBidArray(nx, ny, nz), data(data)
+    : CutBidArray(nx, ny, nz), data(data), allocator(0)
   {
     n = nx * ny * nz;
     allocated = false;
@@ -511,7 +803,7 @@ public:
   ///  @note デストラクタで一次元データ領域を開放しない(allocated_=false)
   ///
   CutBidArrayTemplate(CUT_BID* data, int sx, int sy, int sz, int ex, int ey, int ez)
-    : CutBidArray(sx, sy, sz, ex, ey, ez), data(data)
+    : CutBidArray(sx, sy, sz, ex, ey, ez), data(data), allocator(0)
   {
     n = (ex-sx+1) * (ey-sy+1) * (ez-sz+1);
     allocated = false;
@@ -521,7 +813,10 @@ public:
   ///
   ///  @note allocated_=trueの場合のみ一次元データ領域を開放
   ///
-  ~CutBidArrayTemplate() { if (allocated) delete[] data; }
+  ~CutBidArrayTemplate()
+  {
+    if (allocated) deallocateData();
+  }
 
   /// 一要素のバイトサイズを得る.
   size_t getElementSize() const { return sizeof(CUT_BID); }
@@ -592,6 +887,41 @@ public:
     GetCutBid(data[ijk], bid);
   }
 
+  /// データ配置を変更.
+  ///
+  ///  自前で確保した領域は新しい配置に必要なサイズで確保し直し，0でクリアする.
+  ///  インポートした領域はインデクス計算のみ変更するので，
+  ///  呼び出し側でgetStorageSize()要素以上の領域を用意しておくこと
+  ///
+  ///  @param[in] layout データ配置
+  ///
+  void setLayout(CutInfoLayout layout)
+  {
+    if (allocated) deallocateData();
+    setIndexLayout(layout);
+    n = getStorageSize();
+    if (allocated) {
+      data = allocateData();
+      ClearData(data, n);
+    }
+  }
+
+  /// 境界ID(6方向まとめて)をx方向の範囲で得る.
+  ///
+  ///  @param[in] i0,i1 x方向インデクス範囲(i0 <= i < i1)
+  ///  @param[in] j,k   y,z方向インデクス
+  ///  @param[out] bid  境界ID配列(6*(i1-i0)要素, セル毎に6方向)
+  ///
+  void getBidRange(int i0, int i1, int j, int k, BidType bid[]) const
+  {
+    if (i1 <= i0) return;
+    if (getLayout() == CL_LAYOUT_LINEAR) {
+      DecodeCutBid(data + getIndex(i0,j,k), bid, i1 - i0);
+    } else {
+      for (int i = i0; i < i1; i++) GetCutBid(data[getIndex(i,j,k)], &bid[6*(i-i0)]);
+    }
+  }
+
   /// 一次元配列データへのポインタを得る.
   CUT_BID* getDataPointer() const { return data; }
 
@@ -599,9 +929,34 @@ public:
   size_t getDataSize() const { return n; }
 
   /// 全配列データを0クリア.
-  void clear()
+  void clear() { ClearData(data, n); }
+
+  /// 3次元インデクス範囲の配列データを0クリア.
+  ///
+  ///  @param[in] s 開始3次元インデクス
+  ///  @param[in] e 終了3次元インデクスの次
+  ///
+  void clear(const int s[], const int e[])
+  {
+    for (int k = s[2]; k < e[2]; k++) {
+      for (int j = s[1]; j < e[1]; j++) {
+        for (int i = s[0]; i < e[0]; i++) ClearCutBid(data[getIndex(i,j,k)]);
+      }
+    }
+  }
+
+  /// 一次元データ領域を0クリア(OpenMP並列).
+  ///
+  ///  CutPosArrayTemplate::ClearDataと同じ区間分割でfirst touchする
+  ///
+  ///  @param[out] data 一次元データポインタ
+  ///  @param[in] n 一次元データサイズ
+  ///
+  static void ClearData(CUT_BID* data, size_t n)
   {
-    for (size_t i = 0; i < n; i++) ClearCutBid(data[i]);
+    long nl = (long)n;
+#pragma omp parallel for schedule(static)
+    for (long i = 0; i < nl; i++) ClearCutBid(data[i]);
   }
 };
 
@@ -613,6 +968,12 @@ typedef CutPosArrayTemplate<CutPos32> CutPos32Array;
 /// CutPos8型交点座標配列ラッパクラス.
 typedef CutPosArrayTemplate<CutPos8> CutPos8Array;
 
+/// CutPos16型交点座標配列ラッパクラス.
+typedef CutPosArrayTemplate<CutPos16> CutPos16Array;
+
+/// CutPos10型交点座標配列ラッパクラス.
+typedef CutPosArrayTemplate<CutPos10> CutPos10Array;
+
 /// CutBid8型境界ID配列ラッパクラス.
 typedef CutBidArrayTemplate<CutBid8> CutBid8Array;
 
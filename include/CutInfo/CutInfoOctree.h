@@ -273,6 +273,12 @@ typedef CutPosOctreeTemplate<CutPos32, 6> CutPos32Octree;
 /// CutPos8型交点座標データアクセッサクラス.
 typedef CutPosOctreeTemplate<CutPos8, 2> CutPos8Octree;
 
+/// CutPos16型交点座標データアクセッサクラス.
+typedef CutPosOctreeTemplate<CutPos16, 3> CutPos16Octree;
+
+/// CutPos10型交点座標データアクセッサクラス.
+typedef CutPosOctreeTemplate<CutPos10, 2> CutPos10Octree;
+
 /// CutBid8型境界IDデータアクセッサクラス.
 typedef CutBidOctreeTemplate<CutBid8, 2> CutBid8Octree;
 
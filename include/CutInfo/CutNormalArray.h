@@ -23,6 +23,9 @@
 #define CUT_NORMAL_ARRAY_H
 
 #include <cassert>
+#include <cmath>
+#include <cstring>
+#include <algorithm>
 #include "Cutlib.h"
 //#include "CutPolygon.h"
 
@@ -42,6 +45,108 @@ typedef int NormalIndex[6];
 #endif
 
 
+/// 法線ベクトルデータの符号化方式.
+enum CutNormalEncoding {
+  CL_NORMAL_VECTOR = 0,  ///< Normal型(float/double 3成分)のまま格納(デフォルト)
+  CL_NORMAL_OCT16  = 1,  ///< 8ビット×2の八面体符号化(16ビット)
+  CL_NORMAL_OCT32  = 2   ///< 16ビット×2の八面体符号化(32ビット)
+};
+
+
+/// 八面体符号化の法線ベクトル1個あたりの16ビット語数を得る.
+inline int GetOctNormalSize(CutNormalEncoding encoding)
+{
+  return encoding == CL_NORMAL_OCT16 ? 1 : 2;
+}
+
+
+/// 法線ベクトルを八面体符号化.
+/**
+ * @param[in] x,y,z 法線ベクトル
+ * @param[in] encoding 符号化方式(CL_NORMAL_OCT16, CL_NORMAL_OCT32)
+ * @param[out] code 符号(GetOctNormalSize(encoding)語)
+ */
+inline void EncodeOctNormal(double x, double y, double z,
+                            CutNormalEncoding encoding, uint16_t* code)
+{
+  double l = fabs(x) + fabs(y) + fabs(z);
+  double u = l > 0.0 ? x / l : 0.0;
+  double v = l > 0.0 ? y / l : 0.0;
+  if (z < 0.0) {
+    double uf = (1.0 - fabs(v)) * (u >= 0.0 ? 1.0 : -1.0);
+    double vf = (1.0 - fabs(u)) * (v >= 0.0 ? 1.0 : -1.0);
+    u = uf;
+    v = vf;
+  }
+  if (encoding == CL_NORMAL_OCT16) {
+    unsigned qu = (unsigned)floor((u * 0.5 + 0.5) * 255 + 0.5);
+    unsigned qv = (unsigned)floor((v * 0.5 + 0.5) * 255 + 0.5);
+    code[0] = (uint16_t)(qu | (qv << 8));
+  } else {
+    code[0] = (uint16_t)floor((u * 0.5 + 0.5) * 65535 + 0.5);
+    code[1] = (uint16_t)floor((v * 0.5 + 0.5) * 65535 + 0.5);
+  }
+}
+
+
+/// 八面体符号を2次元座標(-1〜1)に戻す.
+inline void GetOctNormalUV(const uint16_t* code, CutNormalEncoding encoding,
+                           float& u, float& v)
+{
+  if (encoding == CL_NORMAL_OCT16) {
+    u = (float)(code[0] & 255) * (2.0f / 255) - 1.0f;
+    v = (float)(code[0] >> 8)  * (2.0f / 255) - 1.0f;
+  } else {
+    u = (float)code[0] * (2.0f / 65535) - 1.0f;
+    v = (float)code[1] * (2.0f / 65535) - 1.0f;
+  }
+}
+
+
+/// 八面体符号化された法線ベクトルを復号(n個まとめて).
+/**
+ *  折り返しを分岐なしの演算で行い，コンパイラのSIMD化を可能にする
+ *
+ * @param[in] code 符号(n*GetOctNormalSize(encoding)語)
+ * @param[in] encoding 符号化方式(CL_NORMAL_OCT16, CL_NORMAL_OCT32)
+ * @param[out] normal 単位法線ベクトル配列
+ * @param[in] n 要素数
+ */
+inline void DecodeOctNormal(const uint16_t* code, CutNormalEncoding encoding,
+                            Normal* normal, size_t n)
+{
+  int w = GetOctNormalSize(encoding);
+  for (size_t l = 0; l < n; l++) {
+    float u, v;
+    GetOctNormalUV(&code[w*l], encoding, u, v);
+    float z = 1.0f - fabsf(u) - fabsf(v);
+    float t = z < 0.0f ? -z : 0.0f;
+    u += u >= 0.0f ? -t : t;
+    v += v >= 0.0f ? -t : t;
+    float r = 1.0f / sqrtf(u*u + v*v + z*z);
+    normal[l][0] = u * r;
+    normal[l][1] = v * r;
+    normal[l][2] = z * r;
+  }
+}
+
+
+/// 八面体符号化の復号誤差(角度)の上限を得る.
+/**
+ *  単位球面上の方向を符号化→復号した時の角度誤差の最大値は
+ *  OCT16で約0.95度，OCT32で約0.0037度
+ *
+ * @param[in] encoding 符号化方式
+ * @return 角度誤差の上限(度, CL_NORMAL_VECTORでは0)
+ */
+inline double GetOctNormalMaxError(CutNormalEncoding encoding)
+{
+  if (encoding == CL_NORMAL_OCT16) return 1.0;
+  if (encoding == CL_NORMAL_OCT32) return 0.005;
+  return 0.0;
+}
+
+
 /// 交点ポリゴンクラス.
 class CutPolygon {
 
@@ -50,7 +155,6 @@ public:
   size_t ijk;  ///< 計算基準点インデクス
   unsigned char d;  ///< 計算基準線分番号(0〜5)
   Triangle* t;      ///< ポリゴンデータへのポインタ
-  int id;       ///< ext_id
 
   /// コンストラクタ.
   ///
@@ -58,36 +162,117 @@ public:
   ///  @param[in] d  計算基準線分番号(0〜5)
   ///  @param[in] t  ポリゴンデータへのポインタ
   ///
-  CutPolygon(size_t ijk, int d, Triangle* t) : ijk(ijk), d(d), t(t) {
-    id = t->get_exid();
-  }
+  CutPolygon(size_t ijk, int d, Triangle* t) : ijk(ijk), d(d), t(t) {}
+
+  /// コンストラクタ(CutPolygonListのチャンク確保用).
+  CutPolygon() {}
 
   /// デストラクタ.
   ~CutPolygon() {}
 
 };
 
+
 /// 交点ポリゴンのリスト.
-typedef std::vector<const CutPolygon*> CutPolygonList;
+///
+///  交点ポリゴンを値として固定サイズのチャンクに格納するスレッド毎のアリーナ.
+///  要素毎のヒープ確保を行わず，clear()は確保済みチャンクを残して
+///  要素数のみ0に戻す(O(1))
+///
+class CutPolygonList {
+
+  std::vector<CutPolygon*> chunks;  ///< チャンク配列
+  size_t nPolygon;                  ///< 格納要素数
+
+public:
+  /// 1チャンクの要素数.
+  static const size_t ChunkSize = 4096;
+
+  /// コンストラクタ.
+  CutPolygonList() : nPolygon(0) {}
+
+  /// デストラクタ.
+  ~CutPolygonList() { release(); }
+
+  /// 交点ポリゴンを追加.
+  ///
+  ///  @param[in] p 交点ポリゴン
+  ///
+  void push_back(const CutPolygon& p) {
+    size_t c = nPolygon / ChunkSize;
+    if (c == chunks.size()) chunks.push_back(new CutPolygon[ChunkSize]);
+    chunks[c][nPolygon % ChunkSize] = p;
+    nPolygon++;
+  }
+
+  /// 格納要素数を得る.
+  size_t size() const { return nPolygon; }
+
+  /// i番目の交点ポリゴンを得る.
+  const CutPolygon& operator[](size_t i) const {
+    return chunks[i / ChunkSize][i % ChunkSize];
+  }
+
+  /// 全要素を削除(チャンクは再利用のため保持).
+  void clear() { nPolygon = 0; }
+
+  /// 全チャンクを解放.
+  void release() {
+    for (size_t c = 0; c < chunks.size(); c++) delete[] chunks[c];
+    chunks.clear();
+    nPolygon = 0;
+  }
+
+private:
+  /// コピーコンストラクタ(使用禁止).
+  CutPolygonList(const CutPolygonList&);
+
+  /// 代入演算子(使用禁止).
+  CutPolygonList& operator=(const CutPolygonList&);
+
+};
+
+
+/// 法線ベクトルデータ格納位置の格納方式.
+enum CutNormalStorage {
+  CL_NORMAL_DENSE  = 0,  ///< 全セルについて格納(デフォルト)
+  CL_NORMAL_SPARSE = 1   ///< 交点を持つセルのみ格納
+};
 
 
 /// 交点ポリゴン法線格納クラス.
+///
+///  CL_NORMAL_SPARSEでは交点を持つセルの一次元インデクスの昇順リストと
+///  セル毎の格納位置のみを保持し，参照は二分探索(O(log n))で行う
+///
 class CutNormalArray : public CutInfoArray {
 
   size_t n;       ///< 一次元データサイズ
   int nNormal;    ///< ユニークな法線ベクトルデータの数
 
   NormalIndex* normalIndexData;  ///< 法線ベクトルデータ格納位置配列
+  CutAllocator* allocator;       ///< 格納位置配列のメモリアロケータ(0の時はnew[])
+  CutNormalStorage storage;      ///< 格納位置の格納方式
+  CutNormalEncoding encoding;    ///< 法線ベクトルデータの符号化方式
+
+  std::vector<size_t> cutCellIndex;  ///< 交点を持つセルの一次元インデクス(CL_NORMAL_SPARSE, 昇順)
+  std::vector<int> cutCellNormalIndex;  ///< 交点を持つセルの格納位置(CL_NORMAL_SPARSE, セル毎に6方向)
 
-  Normal* normalData;  ///< 法線ベクトルデータ配列
+  Normal* normalData;  ///< 法線ベクトルデータ配列(CL_NORMAL_VECTOR)
+  std::vector<uint16_t> octNormalData;  ///< 八面体符号化法線ベクトルデータ配列
 
 
 public:
   /// コンストラクタ.
   ///
   ///  @param[in] nx,ny,nz  配列サイズ(3次元で指定)
+  ///  @param[in] allocator 格納位置配列のメモリアロケータ(0の時はnew[]で確保)
+  ///  @param[in] storage 格納位置の格納方式
   ///
-  CutNormalArray(size_t nx, size_t ny, size_t nz) : CutInfoArray(nx, ny, nz)
+  CutNormalArray(size_t nx, size_t ny, size_t nz, CutAllocator* allocator = 0,
+                 CutNormalStorage storage = CL_NORMAL_DENSE)
+    : CutInfoArray(nx, ny, nz), allocator(allocator), storage(storage),
+      encoding(CL_NORMAL_VECTOR)
   {
     n = nx * ny * nz;
     initNormalIndex();
@@ -97,10 +282,15 @@ public:
   ///
   ///  @param[in] sx,sy,sz 領域開始位置3次元インデクス
   ///  @param[in] ex,ey,ez 領域終了位置3次元インデクス
+  ///  @param[in] allocator 格納位置配列のメモリアロケータ(0の時はnew[]で確保)
+  ///  @param[in] storage 格納位置の格納方式
   ///
-  ///
-  CutNormalArray(int sx, int sy, int sz, int ex, int ey, int ez)
-    : CutInfoArray(sx, sy, sz, ex, ey, ez)
+  CutNormalArray(int sx, int sy, int sz, int ex, int ey, int ez,
+                 CutAllocator* allocator = 0,
+                 CutNormalStorage storage = CL_NORMAL_DENSE)
+    : CutInfoArray(sx, sy, sz, ex, ey, ez),
+      allocator(allocator), storage(storage),
+      encoding(CL_NORMAL_VECTOR)
   {
     n = (ex-sx+1) * (ey-sy+1) * (ez-sz+1);
     initNormalIndex();
@@ -109,8 +299,14 @@ public:
   /// コンストラクタ.
   ///
   ///  @param[in] ndim  配列サイズ(3次元で指定)
+  ///  @param[in] allocator 格納位置配列のメモリアロケータ(0の時はnew[]で確保)
+  ///  @param[in] storage 格納位置の格納方式
   ///
-  CutNormalArray(const size_t ndim[]) : CutInfoArray(ndim[0], ndim[1], ndim[2])
+  CutNormalArray(const size_t ndim[], CutAllocator* allocator = 0,
+                 CutNormalStorage storage = CL_NORMAL_DENSE)
+    : CutInfoArray(ndim[0], ndim[1], ndim[2]),
+      allocator(allocator), storage(storage),
+      encoding(CL_NORMAL_VECTOR)
   {
     n = ndim[0] * ndim[1] * ndim[2];
     initNormalIndex();
@@ -120,9 +316,14 @@ public:
   ///
   ///  @param[in] start 領域開始位置3次元インデクス
   ///  @param[in] end   領域終了位置3次元インデクス
+  ///  @param[in] allocator 格納位置配列のメモリアロケータ(0の時はnew[]で確保)
+  ///  @param[in] storage 格納位置の格納方式
   ///
-  CutNormalArray(int start[], int end[])
-    : CutInfoArray(start[0], start[1], start[2], end[0], end[1], end[2])
+  CutNormalArray(int start[], int end[], CutAllocator* allocator = 0,
+                 CutNormalStorage storage = CL_NORMAL_DENSE)
+    : CutInfoArray(start[0], start[1], start[2], end[0], end[1], end[2]),
+      allocator(allocator), storage(storage),
+      encoding(CL_NORMAL_VECTOR)
   {
     n = (end[0]-start[0]+1) * (end[1]-start[1]+1) * (end[2]-start[2]+1);
     initNormalIndex();
@@ -131,7 +332,7 @@ public:
 
   /// ディストラクタ.
   ~CutNormalArray() {
-    delete[] normalIndexData;
+    deallocateNormalIndex();
     delete[] normalData;
   }
 
@@ -142,86 +343,228 @@ public:
 
   /// 交点ポリゴンリストから法線ベクトルデータを抽出.
   ///
+  ///  同じポリゴンの法線ベクトルは1つにまとめ，最初に現れる
+  ///  (一次元インデクス,方向)の順に番号を付ける.
+  ///  番号はスレッド数,リストの内容の分かれ方に依存しない
+  ///
   ///  @param[in,out] cutPolygonList[] 交点ポリゴンリスト
   ///  @param[in] nThread スレッド数(交点ポリゴンリスト数)
   ///
-  ///  @note Triangleクラスのext_idを作業用変数として使用
-  ///  @note 終了時に交点ポリゴンリストの各要素のメモリを解放する
+  ///  @note ポリゴンデータ(Triangle)は変更しない
+  ///  @note 終了時に交点ポリゴンリストをクリアする(チャンクは保持)
   ///
   void setNormalInfo(CutPolygonList* cutPolygonList, int nThread) {
-    std::vector<Triangle*> tList;
-    CutPolygonList::iterator it;
-
-    // 作業用に使用するext_idの初期化(元の値はセーブ済み)
+    // 全リストを連結した時の各リストの開始位置
+    std::vector<size_t> offset(nThread + 1, 0);
     for (int i = 0; i < nThread; i++) {
-      for (it = cutPolygonList[i].begin(); it != cutPolygonList[i].end(); ++it) {
-        (*it)->t->set_exid(-1);
-      }
+      offset[i+1] = offset[i] + cutPolygonList[i].size();
     }
-    for (int i = 0; i < nThread; i++) {
-      for (it = cutPolygonList[i].begin(); it != cutPolygonList[i].end(); ++it) {
-        Triangle* t = (*it)->t;
-        int id = t->get_exid();
-        if (id < 0) {
-          tList.push_back(t);
-          t->set_exid(nNormal);
-          nNormal++;
-        }
-      }
+    long nEntry = (long)offset[nThread];
+
+    // (ポリゴン, 一次元インデクス*6+方向)の組を作成
+    std::vector<NormalKey> entry(nEntry);
+#pragma omp parallel for schedule(static)
+    for (long e = 0; e < nEntry; e++) {
+      const CutPolygon& p = getPolygon(cutPolygonList, offset, e);
+      entry[e].t = p.t;
+      entry[e].key = p.ijk * 6 + p.d;
     }
+
+    // ブロック毎にポリゴンでソートし，ポリゴン毎に最小のkeyを残す
+    int nBlock = nThread > 0 ? nThread : 1;
+    std::vector<NormalKey> unique;
+    std::vector<size_t> nUnique(nBlock, 0);
+#pragma omp parallel for schedule(dynamic)
+    for (int b = 0; b < nBlock; b++) {
+      size_t e0 = nEntry * b / nBlock;
+      size_t e1 = nEntry * (b + 1) / nBlock;
+      std::vector<NormalKey> block(entry.begin() + e0, entry.begin() + e1);
+      std::sort(block.begin(), block.end(), NormalKey::LessPolygon);
+      nUnique[b] = ReduceByPolygon(block);
+      std::copy(block.begin(), block.begin() + nUnique[b], entry.begin() + e0);
+    }
+    for (int b = 0; b < nBlock; b++) {
+      size_t e0 = nEntry * b / nBlock;
+      unique.insert(unique.end(), entry.begin() + e0,
+                                  entry.begin() + e0 + nUnique[b]);
+    }
+    std::sort(unique.begin(), unique.end(), NormalKey::LessPolygon);
+    unique.resize(ReduceByPolygon(unique));
+
+    // 最初に現れる位置の順に番号付けし，法線ベクトルデータを作成
+    std::sort(unique.begin(), unique.end(), NormalKey::LessKey);
+    nNormal = (int)unique.size();
 #ifdef CUTLIB_DEBUG
-    int listSize = 0;
-    for (int i = 0; i < nThread; i++) listSize += cutPolygonList[i].size();
-    std::cout << "CutNormalArray: normal data compress: " << listSize
+    std::cout << "CutNormalArray: normal data compress: " << nEntry
               << " -> " << nNormal << std::endl;
 #endif
-    normalData = new Normal[nNormal];
-    for (int i = 0; i < nNormal; i++) {
-      Vec3r n = tList[i]->get_normal();
-      normalData[i][0] = n[0];
-      normalData[i][1] = n[1];
-      normalData[i][2] = n[2];
+    delete[] normalData;
+    normalData = 0;
+    if (encoding == CL_NORMAL_VECTOR) {
+      normalData = new Normal[nNormal];
+    } else {
+      octNormalData.resize(nNormal * GetOctNormalSize(encoding));
     }
-    for (int i = 0; i < nThread; i++) {
-      for (it = cutPolygonList[i].begin(); it != cutPolygonList[i].end(); ++it) {
-        int ijk = (*it)->ijk;
-        assert(0 <= ijk && ijk < n);
-        int d = (*it)->d;
-        assert(0 <= d && d < 6);
-        int id = (*it)->t->get_exid();
-        assert(0 <= id && id < nNormal);
-    //  std::cout << ijk << ":" << d << " -> " << id << " ("
-    //            << normalData[id][0] << ", "
-    //            << normalData[id][1] << ", "
-    //            << normalData[id][2] << ")" << std::endl;
-        normalIndexData[ijk][d] = id;
+#pragma omp parallel for schedule(static)
+    for (int id = 0; id < nNormal; id++) {
+      Vec3r n = unique[id].t->get_normal();
+      if (encoding == CL_NORMAL_VECTOR) {
+        normalData[id][0] = n[0];
+        normalData[id][1] = n[1];
+        normalData[id][2] = n[2];
+      } else {
+        EncodeOctNormal(n[0], n[1], n[2], encoding,
+                        &octNormalData[id * GetOctNormalSize(encoding)]);
       }
+      unique[id].key = id;
+    }
+    std::sort(unique.begin(), unique.end(), NormalKey::LessPolygon);
+
+    // 交点を持つセルのリストを作成(CL_NORMAL_SPARSE)
+    if (storage == CL_NORMAL_SPARSE) {
+      cutCellIndex.resize(nEntry);
+#pragma omp parallel for schedule(static)
+      for (long e = 0; e < nEntry; e++) {
+        cutCellIndex[e] = getPolygon(cutPolygonList, offset, e).ijk;
+      }
+      std::sort(cutCellIndex.begin(), cutCellIndex.end());
+      cutCellIndex.erase(std::unique(cutCellIndex.begin(), cutCellIndex.end()),
+                         cutCellIndex.end());
+      cutCellNormalIndex.assign(cutCellIndex.size() * 6, -1);
     }
 
-    // ext_idの値を戻す
-    // CutPolygonオブジェクトのメモリ解放
-    for (int i = 0; i < nThread; i++) {
-      for (it = cutPolygonList[i].begin(); it != cutPolygonList[i].end(); ++it) {
-        (*it)->t->set_exid((*it)->id);
-        delete *it;
+    // 法線ベクトルデータ格納位置を設定
+#pragma omp parallel for schedule(static)
+    for (long e = 0; e < nEntry; e++) {
+      const CutPolygon& p = getPolygon(cutPolygonList, offset, e);
+      assert(p.ijk < n);
+      assert(p.d < 6);
+      NormalKey k;
+      k.t = p.t;
+      k.key = 0;
+      std::vector<NormalKey>::const_iterator it
+        = std::lower_bound(unique.begin(), unique.end(), k, NormalKey::LessPolygon);
+      assert(it != unique.end() && it->t == p.t);
+      if (storage == CL_NORMAL_SPARSE) {
+        size_t c = std::lower_bound(cutCellIndex.begin(), cutCellIndex.end(), p.ijk)
+                 - cutCellIndex.begin();
+        cutCellNormalIndex[6*c + p.d] = (int)it->key;
+      } else {
+        normalIndexData[p.ijk][p.d] = (int)it->key;
       }
     }
+
+    for (int i = 0; i < nThread; i++) cutPolygonList[i].clear();
+  }
+
+  /// 法線ベクトルデータを全てクリア.
+  ///
+  ///  格納位置を-1(交点なし)に戻し，法線ベクトルデータ配列を解放する
+  ///
+  void clear() {
+    delete[] normalData;
+    initNormalIndexData();
+  }
+
+  /// データ配置を変更.
+  ///
+  ///  格納位置配列を新しい配置に必要なサイズで確保し直し，
+  ///  法線ベクトルデータを全てクリアする
+  ///
+  ///  @param[in] layout データ配置
+  ///
+  void setLayout(CutInfoLayout layout) {
+    deallocateNormalIndex();
+    delete[] normalData;
+    setIndexLayout(layout);
+    n = getStorageSize();
+    initNormalIndex();
   }
 
   ///  ユニークな法線ベクトルデータの総数を取得.
   int getNumNormal() const { return nNormal; }
 
   /// 法線ベクトルデータ配列へのポインタを取得.
+  ///
+  ///  @note CL_NORMAL_VECTOR以外では0
+  ///
   Normal* getNormalDataPointer() const { return normalData; }
 
+  /// 法線ベクトルデータの符号化方式を設定.
+  ///
+  ///  法線ベクトルデータを全てクリアし，次のsetNormalInfoから適用する
+  ///
+  ///  @param[in] encoding 符号化方式
+  ///
+  void setEncoding(CutNormalEncoding encoding) {
+    this->encoding = encoding;
+    clear();
+  }
+
+  /// 法線ベクトルデータの符号化方式を得る.
+  CutNormalEncoding getEncoding() const { return encoding; }
+
+  /// 八面体符号化法線ベクトルデータ配列へのポインタを取得.
+  ///
+  ///  1個あたりGetOctNormalSize(getEncoding())語.
+  ///  CL_NORMAL_VECTORでは0
+  ///
+  const uint16_t* getOctNormalDataPointer() const {
+    return octNormalData.empty() ? 0 : &octNormalData[0];
+  }
+
+  /// 全ての法線ベクトルデータを復号して取得.
+  ///
+  ///  @param[out] normal 法線ベクトル配列(getNumNormal()要素)
+  ///
+  void getNormalData(Normal* normal) const {
+    if (encoding == CL_NORMAL_VECTOR) {
+      memcpy(normal, normalData, sizeof(Normal) * nNormal);
+    } else if (nNormal > 0) {
+      DecodeOctNormal(&octNormalData[0], encoding, normal, nNormal);
+    }
+  }
+
   /// 法線ベクトルデータ格納位置配列.
+  ///
+  ///  @note CL_NORMAL_SPARSEでは0
+  ///
   NormalIndex* getNormalIndexDataPointer() const { return normalIndexData; }
 
+  /// 格納位置の格納方式を得る.
+  CutNormalStorage getStorage() const { return storage; }
+
+  /// 交点を持つセル数を得る(CL_NORMAL_SPARSE).
+  size_t getNumCutCell() const { return cutCellIndex.size(); }
+
+  /// c番目の交点を持つセルの一次元インデクスを得る(CL_NORMAL_SPARSE).
+  size_t getCutCellIndex(size_t c) const { return cutCellIndex[c]; }
+
+  /// 法線ベクトルデータ格納位置を得る.
+  ///
+  ///  @param[in] ijk 1次元インデックス
+  ///  @param[in] d 交点探査方向(0〜5)
+  ///  @return 法線ベクトルデータ格納位置(交点なしの時は-1)
+  ///
+  int getNormalIndex(size_t ijk, int d) const {
+    if (storage == CL_NORMAL_DENSE) return normalIndexData[ijk][d];
+    std::vector<size_t>::const_iterator it
+      = std::lower_bound(cutCellIndex.begin(), cutCellIndex.end(), ijk);
+    if (it == cutCellIndex.end() || *it != ijk) return -1;
+    return cutCellNormalIndex[6*(it - cutCellIndex.begin()) + d];
+  }
+
   /// 法線ベクトルデータの取得.
+  ///
+  ///  交点なし(格納位置-1)の時は零ベクトルを返す
+  ///
   void getNormal(size_t ijk, int d, Normal& normal) const {
-    int id = normalIndexData[ijk][d];
+    int id = getNormalIndex(ijk, d);
     if (id < 0) {
-      normal[0] = normal[1] = normal[2];
+      normal[0] = normal[1] = normal[2] = 0;
+    } else if (encoding != CL_NORMAL_VECTOR) {
+      DecodeOctNormal(&octNormalData[id * GetOctNormalSize(encoding)], encoding,
+                      &normal, 1);
     } else {
       normal[0] = normalData[id][0];
       normal[1] = normalData[id][1];
@@ -246,15 +589,89 @@ public:
 
 private:
 
+  /// 法線ベクトルデータ抽出用の(ポリゴン, 位置)の組.
+  struct NormalKey {
+    Triangle* t;  ///< ポリゴンデータへのポインタ
+    size_t key;   ///< 一次元インデクス*6+方向(番号付け後は法線ベクトル番号)
+
+    /// ポリゴン,位置の順で比較.
+    static bool LessPolygon(const NormalKey& a, const NormalKey& b) {
+      return a.t < b.t || (a.t == b.t && a.key < b.key);
+    }
+
+    /// 位置で比較.
+    static bool LessKey(const NormalKey& a, const NormalKey& b) {
+      return a.key < b.key;
+    }
+  };
+
+  /// 連結した交点ポリゴンリストのe番目の要素を得る.
+  ///
+  ///  @param[in] cutPolygonList[] 交点ポリゴンリスト
+  ///  @param[in] offset 各リストの開始位置(リスト数+1個)
+  ///  @param[in] e 連結したリストでの位置
+  ///
+  static const CutPolygon& getPolygon(const CutPolygonList* cutPolygonList,
+                                      const std::vector<size_t>& offset, size_t e) {
+    int i = (int)(std::upper_bound(offset.begin(), offset.end(), e)
+                  - offset.begin()) - 1;
+    return cutPolygonList[i][e - offset[i]];
+  }
+
+  /// ポリゴンでソート済みの組を，ポリゴン毎に最小の位置の組1つにまとめる.
+  ///
+  ///  @param[in,out] v ポリゴン,位置の順でソート済みの組
+  ///  @return まとめた後の要素数(先頭から格納)
+  ///
+  static size_t ReduceByPolygon(std::vector<NormalKey>& v) {
+    size_t m = 0;
+    for (size_t l = 0; l < v.size(); l++) {
+      if (m > 0 && v[m-1].t == v[l].t) continue;
+      v[m++] = v[l];
+    }
+    return m;
+  }
+
   /// 法線ベクトルデータ格納位置配列の初期化.
   void initNormalIndex() {
-    normalIndexData = new NormalIndex[n];
-    for (int ijk = 0; ijk < n; ijk++) {
+    if (storage == CL_NORMAL_SPARSE) {
+      normalIndexData = 0;
+    } else if (allocator) {
+      normalIndexData = static_cast<NormalIndex*>(
+                          allocator->allocate(n * sizeof(NormalIndex)));
+    } else {
+      normalIndexData = new NormalIndex[n];
+    }
+    initNormalIndexData();
+  }
+
+  /// 法線ベクトルデータ格納位置配列を解放.
+  void deallocateNormalIndex() {
+    if (!normalIndexData) return;
+    if (allocator) {
+      allocator->deallocate(normalIndexData, n * sizeof(NormalIndex));
+    } else {
+      delete[] normalIndexData;
+    }
+  }
+
+  /// 法線ベクトルデータ格納位置を-1(交点なし)に戻し，法線ベクトルデータを空にする.
+  void initNormalIndexData() {
+    std::vector<size_t>().swap(cutCellIndex);
+    std::vector<int>().swap(cutCellNormalIndex);
+    std::vector<uint16_t>().swap(octNormalData);
+    nNormal = 0;
+    normalData = 0;
+    if (storage == CL_NORMAL_SPARSE) return;
+
+    long nl = (long)n;
+    // 交点座標配列と同じ区間分割でfirst touch
+#pragma omp parallel for schedule(static)
+    for (long ijk = 0; ijk < nl; ijk++) {
       for (int d = 0; d < 6; d++) {
         normalIndexData[ijk][d] = -1;
       }
     }
-    nNormal = 0;
   }
 
 };
@@ -0,0 +1,442 @@
+/*
+###################################################################################
+#
+# Cutlib - Cut Information Library
+#
+# Copyright (c) 2010-2011 VCAD System Research Program, RIKEN.
+# All rights reserved.
+#
+# Copyright (c) 2012-2015 Advanced Institute for Computational Science, RIKEN.
+# All rights reserved.
+#
+# Copyright (c) 2016-2017 Research Institute for Information Technology (RIIT), Kyushu University.
+# All rights reserved.
+#
+###################################################################################
+*/
+
+
+/// @file
+/// @brief 交点情報ページ配列クラス
+///
+
+#ifndef CUTINFO_PAGED_ARRAY_H
+#define CUTINFO_PAGED_ARRAY_H
+
+#include <vector>
+#include <cstring>   // for memcpy, memcmp
+
+#include "CutInfoArray.h"
+
+namespace cutlib {
+
+/// @defgroup CutPagedArray 交点情報ページ配列クラス
+//@{
+
+/// ブリック単位ページテーブルクラステンプレート.
+///
+///  領域をBRICK^3セルのブリックに分割し，ブリック毎のデータ領域(ページ)を
+///  最初に書き込まれた時に確保する.
+///  未確保のブリックはクリア値で埋めた共有の読み出し専用ページを指す.
+///
+///  @note ページの確保はOpenMPのcritical区間で行うため，
+///        異なるセルへの並列書き込みは可能.
+///        ページポインタはatomic read/writeで読み書きし，確保済みページを
+///        読む前にflushするため，ページ内容の書き込みが見える前に
+///        新しいポインタを参照することはない
+///
+template<typename T, int BRICK>
+class CutPageTable {
+
+  size_t nx, ny, nz;       ///< 領域サイズ
+  size_t nBrick[3];        ///< 各方向のブリック数
+  std::vector<T*> pages;   ///< ブリック毎のページ(未確保時はclearPage)
+  T* clearPage;            ///< 共有クリアページ
+  size_t nAllocated;       ///< 確保済みページ数
+
+public:
+  /// 1ページのセル数.
+  static const int PageSize = BRICK * BRICK * BRICK;
+
+  /// コンストラクタ.
+  ///
+  ///  @param[in] nx,ny,nz 領域サイズ
+  ///  @param[in] clearValue クリア値
+  ///
+  CutPageTable(size_t nx, size_t ny, size_t nz, const T& clearValue)
+    : nx(nx), ny(ny), nz(nz), nAllocated(0)
+  {
+    nBrick[0] = (nx + BRICK - 1) / BRICK;
+    nBrick[1] = (ny + BRICK - 1) / BRICK;
+    nBrick[2] = (nz + BRICK - 1) / BRICK;
+    clearPage = new T[PageSize];
+    for (int l = 0; l < PageSize; l++) memcpy(&clearPage[l], &clearValue, sizeof(T));
+    pages.assign(nBrick[0] * nBrick[1] * nBrick[2], clearPage);
+  }
+
+  /// デストラクタ.
+  ~CutPageTable() {
+    clear();
+    delete[] clearPage;
+  }
+
+  /// 全ページを解放(全セルがクリア値になる).
+  void clear() {
+    for (size_t b = 0; b < pages.size(); b++) {
+      if (pages[b] != clearPage) delete[] pages[b];
+      pages[b] = clearPage;
+    }
+    nAllocated = 0;
+  }
+
+  /// 相対インデクス(i,j,k)のブリック番号とページ内位置を得る.
+  void locate(size_t i, size_t j, size_t k, size_t& b, size_t& l) const {
+    b = (i / BRICK) + (j / BRICK) * nBrick[0] + (k / BRICK) * nBrick[0] * nBrick[1];
+    l = (i % BRICK) + (j % BRICK) * BRICK + (k % BRICK) * BRICK * BRICK;
+  }
+
+  /// 一次元インデクス(i + j*nx + k*nx*ny)のブリック番号とページ内位置を得る.
+  void locate(size_t ijk, size_t& b, size_t& l) const {
+    locate(ijk % nx, (ijk / nx) % ny, ijk / (nx * ny), b, l);
+  }
+
+  /// 読み出し用に要素を得る.
+  const T& get(size_t b, size_t l) const { return getPage(b)[l]; }
+
+  /// 書き込み用に要素を得る(ページ未確保なら確保).
+  T& getWritable(size_t b, size_t l) {
+    T* page = getPage(b);
+    if (page == clearPage) {
+#pragma omp critical (CutPageTable_allocate)
+      {
+        page = pages[b];
+        if (page == clearPage) {
+          page = new T[PageSize];
+          memcpy(page, clearPage, sizeof(T) * PageSize);
+#pragma omp flush
+#pragma omp atomic write
+          pages[b] = page;
+          nAllocated++;
+        }
+      }
+    }
+    return page[l];
+  }
+
+  /// ブリックbのページが確保されているか.
+  bool isAllocated(size_t b) const { return getPage(b) != clearPage; }
+
+  /// ブリック総数を得る.
+  size_t getNumPage() const { return pages.size(); }
+
+  /// 確保済みページ数を得る.
+  size_t getNumAllocated() const { return nAllocated; }
+
+  /// 使用メモリ量(バイト)を得る.
+  size_t getMemorySize() const {
+    return (nAllocated + 1) * sizeof(T) * PageSize + pages.size() * sizeof(T*);
+  }
+
+private:
+  /// ブリックbのページを得る.
+  ///
+  ///  確保済みページは，ポインタを読んだ後にflushして内容を参照する
+  ///  (共有クリアページは並列区間の開始前に書き込み済み)
+  ///
+  T* getPage(size_t b) const {
+    T* page;
+#pragma omp atomic read
+    page = pages[b];
+    if (page != clearPage) {
+#pragma omp flush
+    }
+    return page;
+  }
+
+  /// コピーコンストラクタ(使用禁止).
+  CutPageTable(const CutPageTable&);
+
+  /// 代入演算子(使用禁止).
+  CutPageTable& operator=(const CutPageTable&);
+
+};
+
+
+/// 交点座標ページ配列クラステンプレート.
+///
+///  交点を持つセルを含むブリックのみデータ領域を確保する.
+///  クリア値(1.0)の書き込みではページを確保しない.
+///
+template<typename CUT_POS, int BRICK = 8>
+class CutPosPagedArrayTemplate : public CutPosArray {
+
+  CutPageTable<CUT_POS, BRICK>* table;  ///< ページテーブル
+
+  /// クリア値を得る.
+  static CUT_POS* clearValue(CUT_POS& cp) { ClearCutPos(cp); return &cp; }
+
+  /// 要素を書き換え(値が変わる時のみページを確保).
+  void update(int i, int j, int k, const CUT_POS& cp) {
+    size_t b, l;
+    table->locate(i - getStartX(), j - getStartY(), k - getStartZ(), b, l);
+    if (memcmp(&table->get(b, l), &cp, sizeof(CUT_POS)) == 0) return;
+    memcpy(&table->getWritable(b, l), &cp, sizeof(CUT_POS));
+  }
+
+  /// 要素を得る.
+  const CUT_POS& element(int i, int j, int k) const {
+    size_t b, l;
+    table->locate(i - getStartX(), j - getStartY(), k - getStartZ(), b, l);
+    return table->get(b, l);
+  }
+
+  /// 要素を得る(1次元インデックスで指定).
+  const CUT_POS& element(size_t ijk) const {
+    size_t b, l;
+    table->locate(ijk, b, l);
+    return table->get(b, l);
+  }
+
+public:
+  /// コンストラクタ.
+  ///
+  ///  @param[in] nx,ny,nz  配列サイズ(3次元で指定)
+  ///
+  CutPosPagedArrayTemplate(size_t nx, size_t ny, size_t nz)
+    : CutPosArray(nx, ny, nz)
+  {
+    CUT_POS cp;
+    table = new CutPageTable<CUT_POS, BRICK>(nx, ny, nz, *clearValue(cp));
+  }
+
+  /// コンストラクタ.
+  ///
+  ///  @param[in] sx,sy,sz 領域開始位置3次元インデクス
+  ///  @param[in] ex,ey,ez 領域終了位置3次元インデクス
+  ///
+  CutPosPagedArrayTemplate(int sx, int sy, int sz, int ex, int ey, int ez)
+    : CutPosArray(sx, sy, sz, ex, ey, ez)
+  {
+    CUT_POS cp;
+    table = new CutPageTable<CUT_POS, BRICK>(getSizeX(), getSizeY(), getSizeZ(),
+                                             *clearValue(cp));
+  }
+
+  /// コンストラクタ.
+  ///
+  ///  @param[in] ndim  配列サイズ(3次元で指定)
+  ///
+  CutPosPagedArrayTemplate(const size_t ndim[])
+    : CutPosArray(ndim[0], ndim[1], ndim[2])
+  {
+    CUT_POS cp;
+    table = new CutPageTable<CUT_POS, BRICK>(ndim[0], ndim[1], ndim[2],
+                                             *clearValue(cp));
+  }
+
+  /// デストラクタ.
+  ~CutPosPagedArrayTemplate() { delete table; }
+
+  /// 一要素のバイトサイズを得る.
+  size_t getElementSize() const { return sizeof(CUT_POS); }
+
+  /// 交点座標値を設定(d方向).
+  void setPos(int i, int j, int k, int d, float pos) {
+    CUT_POS cp;
+    memcpy(&cp, &element(i, j, k), sizeof(CUT_POS));
+    SetCutPos(cp, d, pos);
+    update(i, j, k, cp);
+  }
+
+  /// 交点座標値を設定(6方向まとめて).
+  void setPos(int i, int j, int k, const float pos[]) {
+    CUT_POS cp;
+    memcpy(&cp, &element(i, j, k), sizeof(CUT_POS));
+    SetCutPos(cp, pos);
+    update(i, j, k, cp);
+  }
+
+  /// 交点座標値(d方向)を得る.
+  float getPos(int i, int j, int k, int d) const {
+    return GetCutPos(element(i, j, k), d);
+  }
+
+  /// 交点座標値(d方向)を得る(1次元インデックスで指定).
+  float getPos(size_t ijk, int d) const {
+    return GetCutPos(element(ijk), d);
+  }
+
+  /// 交点座標値(6方向まとめて)を得る.
+  void getPos(int i, int j, int k, float pos[]) const {
+    GetCutPos(element(i, j, k), pos);
+  }
+
+  /// 交点座標値(6方向まとめて)を得る(1次元インデックスで指定).
+  void getPos(size_t ijk, float pos[]) const {
+    GetCutPos(element(ijk), pos);
+  }
+
+  /// 全配列データを1.0でクリア(全ページを解放).
+  void clear() { table->clear(); }
+
+  /// ページテーブルを得る.
+  const CutPageTable<CUT_POS, BRICK>* getPageTable() const { return table; }
+
+private:
+  /// コピーコンストラクタ(使用禁止).
+  CutPosPagedArrayTemplate(const CutPosPagedArrayTemplate&);
+
+  /// 代入演算子(使用禁止).
+  CutPosPagedArrayTemplate& operator=(const CutPosPagedArrayTemplate&);
+
+};
+
+
+/// 境界IDページ配列クラステンプレート.
+///
+///  交点を持つセルを含むブリックのみデータ領域を確保する.
+///  クリア値(0)の書き込みではページを確保しない.
+///
+template<typename CUT_BID, int BRICK = 8>
+class CutBidPagedArrayTemplate : public CutBidArray {
+
+  CutPageTable<CUT_BID, BRICK>* table;  ///< ページテーブル
+
+  /// クリア値を得る.
+  static CUT_BID* clearValue(CUT_BID& cb) { ClearCutBid(cb); return &cb; }
+
+  /// 要素を書き換え(値が変わる時のみページを確保).
+  void update(int i, int j, int k, const CUT_BID& cb) {
+    size_t b, l;
+    table->locate(i - getStartX(), j - getStartY(), k - getStartZ(), b, l);
+    if (memcmp(&table->get(b, l), &cb, sizeof(CUT_BID)) == 0) return;
+    memcpy(&table->getWritable(b, l), &cb, sizeof(CUT_BID));
+  }
+
+  /// 要素を得る.
+  const CUT_BID& element(int i, int j, int k) const {
+    size_t b, l;
+    table->locate(i - getStartX(), j - getStartY(), k - getStartZ(), b, l);
+    return table->get(b, l);
+  }
+
+  /// 要素を得る(1次元インデックスで指定).
+  const CUT_BID& element(size_t ijk) const {
+    size_t b, l;
+    table->locate(ijk, b, l);
+    return table->get(b, l);
+  }
+
+public:
+  /// コンストラクタ.
+  ///
+  ///  @param[in] nx,ny,nz  配列サイズ(3次元で指定)
+  ///
+  CutBidPagedArrayTemplate(size_t nx, size_t ny, size_t nz)
+    : CutBidArray(nx, ny, nz)
+  {
+    CUT_BID cb;
+    table = new CutPageTable<CUT_BID, BRICK>(nx, ny, nz, *clearValue(cb));
+  }
+
+  /// コンストラクタ.
+  ///
+  ///  @param[in] sx,sy,sz 領域開始位置3次元インデクス
+  ///  @param[in] ex,ey,ez 領域終了位置3次元インデクス
+  ///
+  CutBidPagedArrayTemplate(int sx, int sy, int sz, int ex, int ey, int ez)
+    : CutBidArray(sx, sy, sz, ex, ey, ez)
+  {
+    CUT_BID cb;
+    table = new CutPageTable<CUT_BID, BRICK>(getSizeX(), getSizeY(), getSizeZ(),
+                                             *clearValue(cb));
+  }
+
+  /// コンストラクタ.
+  ///
+  ///  @param[in] ndim  配列サイズ(3次元で指定)
+  ///
+  CutBidPagedArrayTemplate(const size_t ndim[])
+    : CutBidArray(ndim[0], ndim[1], ndim[2])
+  {
+    CUT_BID cb;
+    table = new CutPageTable<CUT_BID, BRICK>(ndim[0], ndim[1], ndim[2],
+                                             *clearValue(cb));
+  }
+
+  /// デストラクタ.
+  ~CutBidPagedArrayTemplate() { delete table; }
+
+  /// 一要素のバイトサイズを得る.
+  size_t getElementSize() const { return sizeof(CUT_BID); }
+
+  /// 境界IDを設定(d方向).
+  void setBid(int i, int j, int k, int d, BidType bid) {
+    CUT_BID cb;
+    memcpy(&cb, &element(i, j, k), sizeof(CUT_BID));
+    SetCutBid(cb, d, bid);
+    update(i, j, k, cb);
+  }
+
+  /// 境界IDを設定(6方向まとめて).
+  void setBid(int i, int j, int k, const BidType bid[]) {
+    CUT_BID cb;
+    memcpy(&cb, &element(i, j, k), sizeof(CUT_BID));
+    SetCutBid(cb, bid);
+    update(i, j, k, cb);
+  }
+
+  /// 境界ID(d方向)を得る.
+  BidType getBid(int i, int j, int k, int d) const {
+    return GetCutBid(element(i, j, k), d);
+  }
+
+  /// 境界ID(d方向)を得る(1次元インデックスで指定).
+  BidType getBid(size_t ijk, int d) const {
+    return GetCutBid(element(ijk), d);
+  }
+
+  /// 境界ID(6方向まとめて)を得る.
+  void getBid(int i, int j, int k, BidType bid[]) const {
+    GetCutBid(element(i, j, k), bid);
+  }
+
+  /// 境界ID(6方向まとめて)を得る(1次元インデックスで指定).
+  void getBid(size_t ijk, BidType bid[]) const {
+    GetCutBid(element(ijk), bid);
+  }
+
+  /// 全配列データを0クリア(全ページを解放).
+  void clear() { table->clear(); }
+
+  /// ページテーブルを得る.
+  const CutPageTable<CUT_BID, BRICK>* getPageTable() const { return table; }
+
+private:
+  /// コピーコンストラクタ(使用禁止).
+  CutBidPagedArrayTemplate(const CutBidPagedArrayTemplate&);
+
+  /// 代入演算子(使用禁止).
+  CutBidPagedArrayTemplate& operator=(const CutBidPagedArrayTemplate&);
+
+};
+
+//-----------------------------------------------------------------------------
+
+/// CutPos32型交点座標ページ配列クラス.
+typedef CutPosPagedArrayTemplate<CutPos32> CutPos32PagedArray;
+
+/// CutPos8型交点座標ページ配列クラス.
+typedef CutPosPagedArrayTemplate<CutPos8> CutPos8PagedArray;
+
+/// CutBid8型境界IDページ配列クラス.
+typedef CutBidPagedArrayTemplate<CutBid8> CutBid8PagedArray;
+
+/// CutBid5型境界IDページ配列クラス.
+typedef CutBidPagedArrayTemplate<CutBid5> CutBid5PagedArray;
+
+//@} end group CutPagedArray
+
+} // namespace cutlib
+
+#endif // CUTINFO_PAGED_ARRAY_H
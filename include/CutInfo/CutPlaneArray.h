@@ -0,0 +1,475 @@
+/*
+###################################################################################
+#
+# Cutlib - Cut Information Library
+#
+# Copyright (c) 2010-2011 VCAD System Research Program, RIKEN.
+# All rights reserved.
+#
+# Copyright (c) 2012-2015 Advanced Institute for Computational Science, RIKEN.
+# All rights reserved.
+#
+# Copyright (c) 2016-2017 Research Institute for Information Technology (RIIT), Kyushu University.
+# All rights reserved.
+#
+###################################################################################
+*/
+
+
+/// @file
+/// @brief 交点情報方向別プレーン配列クラス
+///
+
+#ifndef CUTINFO_PLANE_ARRAY_H
+#define CUTINFO_PLANE_ARRAY_H
+
+#include "CutInfoArray.h"
+
+namespace cutlib {
+
+/// @defgroup CutPlaneArray 交点情報方向別プレーン配列クラス
+//@{
+
+/// プレーン要素に交点座標値を設定(float).
+inline void SetPlanePos(float& p, float pos) { p = pos; }
+
+/// プレーン要素に交点座標値を設定(8ビット量子化, CutPos8と同じ).
+inline void SetPlanePos(unsigned char& p, float pos)
+{
+  p = (unsigned char)(pos*255);
+}
+
+/// プレーン要素から交点座標値を得る(float).
+inline float GetPlanePos(float p) { return p; }
+
+/// プレーン要素から交点座標値を得る(8ビット量子化).
+inline float GetPlanePos(unsigned char p) { return (float)p / 255; }
+
+
+/// 交点座標方向別プレーン配列クラステンプレート.
+///
+///  6方向の交点座標をそれぞれ連続した一次元配列(プレーン)として格納する.
+///  方向別の計算ではgetPlanePointer(d)で得たプレーンを単位ストライドで参照できる
+///
+///  @note T=float(32ビット)またはunsigned char(8ビット量子化)
+///
+template<typename T>
+class CutPosPlaneArrayTemplate : public CutPosArray {
+  size_t n;        ///< 一プレーンのデータサイズ
+  T* data;         ///< データポインタ(6プレーン連続)
+  CutAllocator* allocator;  ///< メモリアロケータ(0の時はnew[]/delete[])
+
+  /// データ領域を確保し，1.0でクリア.
+  void allocateData()
+  {
+    if (allocator) {
+      data = static_cast<T*>(allocator->allocate(6 * n * sizeof(T)));
+    } else {
+      data = new T[6 * n];
+    }
+    clear();
+  }
+
+  /// データ領域を解放.
+  void deallocateData()
+  {
+    if (allocator) {
+      allocator->deallocate(data, 6 * n * sizeof(T));
+    } else {
+      delete[] data;
+    }
+  }
+
+public:
+  /// コンストラクタ.
+  ///
+  ///  @param[in] nx,ny,nz  配列サイズ(3次元で指定)
+  ///  @param[in] allocator メモリアロケータ(0の時はnew[]で確保)
+  ///
+  CutPosPlaneArrayTemplate(size_t nx, size_t ny, size_t nz,
+                           CutAllocator* allocator = 0)
+    : CutPosArray(nx, ny, nz), allocator(allocator)
+  {
+    n = getStorageSize();
+    allocateData();
+  }
+
+  /// コンストラクタ.
+  ///
+  ///  @param[in] sx,sy,sz 領域開始位置3次元インデクス
+  ///  @param[in] ex,ey,ez 領域終了位置3次元インデクス
+  ///  @param[in] allocator メモリアロケータ(0の時はnew[]で確保)
+  ///
+  CutPosPlaneArrayTemplate(int sx, int sy, int sz, int ex, int ey, int ez,
+                           CutAllocator* allocator = 0)
+    : CutPosArray(sx, sy, sz, ex, ey, ez), allocator(allocator)
+  {
+    n = getStorageSize();
+    allocateData();
+  }
+
+  /// コンストラクタ.
+  ///
+  ///  @param[in] ndim  配列サイズ(3次元で指定)
+  ///  @param[in] allocator メモリアロケータ(0の時はnew[]で確保)
+  ///
+  CutPosPlaneArrayTemplate(const size_t ndim[], CutAllocator* allocator = 0)
+    : CutPosArray(ndim[0], ndim[1], ndim[2]), allocator(allocator)
+  {
+    n = getStorageSize();
+    allocateData();
+  }
+
+  /// デストラクタ.
+  ~CutPosPlaneArrayTemplate() { deallocateData(); }
+
+  /// 一要素のバイトサイズを得る.
+  size_t getElementSize() const { return 6 * sizeof(T); }
+
+  /// 交点座標値を設定(d方向).
+  ///
+  ///  @param[in] i,j,k 3次元インデックス
+  ///  @param[in] d 交点探査方向(0〜5)
+  ///  @param[in] pos 交点座標値
+  ///
+  void setPos(int i, int j, int k, int d, float pos)
+  {
+    SetPlanePos(data[d*n + getIndex(i,j,k)], pos);
+  }
+
+  /// 交点座標値を設定(6方向まとめて).
+  ///
+  ///  @param[in] i,j,k 3次元インデックス
+  ///  @param[in] pos 交点座標配列
+  ///
+  void setPos(int i, int j, int k, const float pos[])
+  {
+    size_t ijk = getIndex(i,j,k);
+    for (int d = 0; d < 6; d++) SetPlanePos(data[d*n + ijk], pos[d]);
+  }
+
+  /// 交点座標値(d方向)を得る.
+  ///
+  ///  @param[in] i,j,k 3次元インデックス
+  ///  @param[in] d 交点探査方向(0〜5)
+  ///  @return 交点座標値
+  ///
+  float getPos(int i, int j, int k, int d) const
+  {
+    return GetPlanePos(data[d*n + getIndex(i,j,k)]);
+  }
+
+  /// 交点座標値(d方向)を得る(1次元インデックスで指定).
+  ///
+  ///  @param[in] ijk 1次元インデックス
+  ///  @param[in] d 交点探査方向(0〜5)
+  ///  @return 交点座標値
+  ///
+  float getPos(size_t ijk, int d) const
+  {
+    return GetPlanePos(data[d*n + ijk]);
+  }
+
+  /// 交点座標値(6方向まとめて)を得る.
+  ///
+  ///  @param[in] i,j,k 3次元インデックス
+  ///  @param[out] pos 交点座標配列
+  ///
+  void getPos(int i, int j, int k, float pos[]) const
+  {
+    getPos(getIndex(i,j,k), pos);
+  }
+
+  /// 交点座標値(6方向まとめて)を得る(1次元インデックスで指定).
+  ///
+  ///  @param[in] ijk 1次元インデックス
+  ///  @param[out] pos 交点座標配列
+  ///
+  void getPos(size_t ijk, float pos[]) const
+  {
+    for (int d = 0; d < 6; d++) pos[d] = GetPlanePos(data[d*n + ijk]);
+  }
+
+  /// 交点座標値(6方向まとめて)をx方向の範囲で得る.
+  ///
+  ///  @param[in] i0,i1 x方向インデクス範囲(i0 <= i < i1)
+  ///  @param[in] j,k   y,z方向インデクス
+  ///  @param[out] pos  交点座標配列(6*(i1-i0)要素, セル毎に6方向)
+  ///
+  void getPosRange(int i0, int i1, int j, int k, float pos[]) const
+  {
+    if (i1 <= i0) return;
+    if (getLayout() != CL_LAYOUT_LINEAR) {
+      CutPosArray::getPosRange(i0, i1, j, k, pos);
+      return;
+    }
+    size_t m = i1 - i0;
+    for (int d = 0; d < 6; d++) {
+      const T* p = data + d*n + getIndex(i0,j,k);
+      for (size_t l = 0; l < m; l++) pos[6*l+d] = GetPlanePos(p[l]);
+    }
+  }
+
+  /// d方向のプレーンへのポインタを得る.
+  ///
+  ///  @param[in] d 交点探査方向(0〜5)
+  ///  @return 1次元インデックスで参照するプレーンの先頭
+  ///
+  T* getPlanePointer(int d) const { return data + d*n; }
+
+  /// 一プレーンのデータサイズを得る.
+  size_t getDataSize() const { return n; }
+
+  /// データ配置を変更.
+  ///
+  ///  新しい配置に必要なサイズで確保し直し，1.0でクリアする
+  ///
+  ///  @param[in] layout データ配置
+  ///
+  void setLayout(CutInfoLayout layout)
+  {
+    deallocateData();
+    setIndexLayout(layout);
+    n = getStorageSize();
+    allocateData();
+  }
+
+  /// 全配列データを1.0でクリア(OpenMP並列, プレーン毎にfirst touch).
+  void clear()
+  {
+    T clearValue;
+    SetPlanePos(clearValue, 1.0f);
+    long nl = (long)n;
+    for (int d = 0; d < 6; d++) {
+      T* plane = data + d*n;
+#pragma omp parallel for schedule(static)
+      for (long i = 0; i < nl; i++) plane[i] = clearValue;
+    }
+  }
+
+private:
+  /// コピーコンストラクタ(使用禁止).
+  CutPosPlaneArrayTemplate(const CutPosPlaneArrayTemplate&);
+
+  /// 代入演算子(使用禁止).
+  CutPosPlaneArrayTemplate& operator=(const CutPosPlaneArrayTemplate&);
+
+};
+
+
+/// 境界ID方向別プレーン配列クラス.
+///
+///  6方向の境界ID(8ビット)をそれぞれ連続した一次元配列(プレーン)として格納する
+///
+class CutBidPlaneArray : public CutBidArray {
+  size_t n;          ///< 一プレーンのデータサイズ
+  BidType* data;     ///< データポインタ(6プレーン連続)
+  CutAllocator* allocator;  ///< メモリアロケータ(0の時はnew[]/delete[])
+
+  /// データ領域を確保し，0クリア.
+  void allocateData()
+  {
+    if (allocator) {
+      data = static_cast<BidType*>(allocator->allocate(6 * n * sizeof(BidType)));
+    } else {
+      data = new BidType[6 * n];
+    }
+    clear();
+  }
+
+  /// データ領域を解放.
+  void deallocateData()
+  {
+    if (allocator) {
+      allocator->deallocate(data, 6 * n * sizeof(BidType));
+    } else {
+      delete[] data;
+    }
+  }
+
+public:
+  /// コンストラクタ.
+  ///
+  ///  @param[in] nx,ny,nz  配列サイズ(3次元で指定)
+  ///  @param[in] allocator メモリアロケータ(0の時はnew[]で確保)
+  ///
+  CutBidPlaneArray(size_t nx, size_t ny, size_t nz, CutAllocator* allocator = 0)
+    : CutBidArray(nx, ny, nz), allocator(allocator)
+  {
+    n = getStorageSize();
+    allocateData();
+  }
+
+  /// コンストラクタ.
+  ///
+  ///  @param[in] sx,sy,sz 領域開始位置3次元インデクス
+  ///  @param[in] ex,ey,ez 領域終了位置3次元インデクス
+  ///  @param[in] allocator メモリアロケータ(0の時はnew[]で確保)
+  ///
+  CutBidPlaneArray(int sx, int sy, int sz, int ex, int ey, int ez,
+                   CutAllocator* allocator = 0)
+    : CutBidArray(sx, sy, sz, ex, ey, ez), allocator(allocator)
+  {
+    n = getStorageSize();
+    allocateData();
+  }
+
+  /// コンストラクタ.
+  ///
+  ///  @param[in] ndim  配列サイズ(3次元で指定)
+  ///  @param[in] allocator メモリアロケータ(0の時はnew[]で確保)
+  ///
+  CutBidPlaneArray(const size_t ndim[], CutAllocator* allocator = 0)
+    : CutBidArray(ndim[0], ndim[1], ndim[2]), allocator(allocator)
+  {
+    n = getStorageSize();
+    allocateData();
+  }
+
+  /// デストラクタ.
+  ~CutBidPlaneArray() { deallocateData(); }
+
+  /// 一要素のバイトサイズを得る.
+  size_t getElementSize() const { return 6 * sizeof(BidType); }
+
+  /// 境界IDを設定(d方向).
+  ///
+  ///  @param[in] i,j,k 3次元インデックス
+  ///  @param[in] d 交点探査方向(0〜5)
+  ///  @param[in] bid 境界ID
+  ///
+  void setBid(int i, int j, int k, int d, BidType bid)
+  {
+    data[d*n + getIndex(i,j,k)] = bid;
+  }
+
+  /// 境界IDを設定(6方向まとめて).
+  ///
+  ///  @param[in] i,j,k 3次元インデックス
+  ///  @param[in] bid 境界ID配列
+  ///
+  void setBid(int i, int j, int k, const BidType bid[])
+  {
+    size_t ijk = getIndex(i,j,k);
+    for (int d = 0; d < 6; d++) data[d*n + ijk] = bid[d];
+  }
+
+  /// 境界ID(d方向)を得る.
+  ///
+  ///  @param[in] i,j,k 3次元インデックス
+  ///  @param[in] d 交点探査方向(0〜5)
+  ///  @return 境界ID
+  ///
+  BidType getBid(int i, int j, int k, int d) const
+  {
+    return data[d*n + getIndex(i,j,k)];
+  }
+
+  /// 境界ID(d方向)を得る(1次元インデックスで指定).
+  ///
+  ///  @param[in] ijk 1次元インデックス
+  ///  @param[in] d 交点探査方向(0〜5)
+  ///  @return 境界ID
+  ///
+  BidType getBid(size_t ijk, int d) const
+  {
+    return data[d*n + ijk];
+  }
+
+  /// 境界ID(6方向まとめて)を得る.
+  ///
+  ///  @param[in] i,j,k 3次元インデックス
+  ///  @param[out] bid  境界ID配列
+  ///
+  void getBid(int i, int j, int k, BidType bid[]) const
+  {
+    getBid(getIndex(i,j,k), bid);
+  }
+
+  /// 境界ID(6方向まとめて)を得る(1次元インデックスで指定).
+  ///
+  ///  @param[in] ijk 1次元インデックス
+  ///  @param[out] bid  境界ID配列
+  ///
+  void getBid(size_t ijk, BidType bid[]) const
+  {
+    for (int d = 0; d < 6; d++) bid[d] = data[d*n + ijk];
+  }
+
+  /// 境界ID(6方向まとめて)をx方向の範囲で得る.
+  ///
+  ///  @param[in] i0,i1 x方向インデクス範囲(i0 <= i < i1)
+  ///  @param[in] j,k   y,z方向インデクス
+  ///  @param[out] bid  境界ID配列(6*(i1-i0)要素, セル毎に6方向)
+  ///
+  void getBidRange(int i0, int i1, int j, int k, BidType bid[]) const
+  {
+    if (i1 <= i0) return;
+    if (getLayout() != CL_LAYOUT_LINEAR) {
+      CutBidArray::getBidRange(i0, i1, j, k, bid);
+      return;
+    }
+    size_t m = i1 - i0;
+    for (int d = 0; d < 6; d++) {
+      const BidType* p = data + d*n + getIndex(i0,j,k);
+      for (size_t l = 0; l < m; l++) bid[6*l+d] = p[l];
+    }
+  }
+
+  /// d方向のプレーンへのポインタを得る.
+  ///
+  ///  @param[in] d 交点探査方向(0〜5)
+  ///  @return 1次元インデックスで参照するプレーンの先頭
+  ///
+  BidType* getPlanePointer(int d) const { return data + d*n; }
+
+  /// 一プレーンのデータサイズを得る.
+  size_t getDataSize() const { return n; }
+
+  /// データ配置を変更.
+  ///
+  ///  新しい配置に必要なサイズで確保し直し，0クリアする
+  ///
+  ///  @param[in] layout データ配置
+  ///
+  void setLayout(CutInfoLayout layout)
+  {
+    deallocateData();
+    setIndexLayout(layout);
+    n = getStorageSize();
+    allocateData();
+  }
+
+  /// 全配列データを0クリア(OpenMP並列, プレーン毎にfirst touch).
+  void clear()
+  {
+    long nl = (long)n;
+    for (int d = 0; d < 6; d++) {
+      BidType* plane = data + d*n;
+#pragma omp parallel for schedule(static)
+      for (long i = 0; i < nl; i++) plane[i] = 0;
+    }
+  }
+
+private:
+  /// コピーコンストラクタ(使用禁止).
+  CutBidPlaneArray(const CutBidPlaneArray&);
+
+  /// 代入演算子(使用禁止).
+  CutBidPlaneArray& operator=(const CutBidPlaneArray&);
+
+};
+
+//-----------------------------------------------------------------------------
+
+/// float型交点座標方向別プレーン配列クラス.
+typedef CutPosPlaneArrayTemplate<float> CutPos32PlaneArray;
+
+/// 8ビット量子化交点座標方向別プレーン配列クラス.
+typedef CutPosPlaneArrayTemplate<unsigned char> CutPos8PlaneArray;
+
+//@} end group CutPlaneArray
+
+} // namespace cutlib
+
+#endif // CUTINFO_PLANE_ARRAY_H
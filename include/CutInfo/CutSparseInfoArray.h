@@ -0,0 +1,287 @@
+/*
+###################################################################################
+#
+# Cutlib - Cut Information Library
+#
+# Copyright (c) 2010-2011 VCAD System Research Program, RIKEN.
+# All rights reserved.
+#
+# Copyright (c) 2012-2015 Advanced Institute for Computational Science, RIKEN.
+# All rights reserved.
+#
+# Copyright (c) 2016-2017 Research Institute for Information Technology (RIIT), Kyushu University.
+# All rights reserved.
+#
+###################################################################################
+*/
+
+
+/// @file
+/// @brief 交点情報疎配列クラス
+///
+
+#ifndef CUTINFO_SPARSE_ARRAY_H
+#define CUTINFO_SPARSE_ARRAY_H
+
+#include <vector>
+#include <algorithm>   // for lower_bound
+#include <cstring>     // for memcpy
+
+#include "CutInfoArray.h"
+
+namespace cutlib {
+
+/// @defgroup CutSparseInfoArray 交点情報疎配列クラス
+//@{
+
+/// 交点情報疎配列クラステンプレート.
+///
+///  いずれかの方向に交点を持つセル(アクティブセル)のみを，
+///  昇順の一次元インデクス列と(交点座標,境界ID)レコード列として保持する.
+///  getPos/getBidは二分探索(O(log n))で参照し，アクティブでない
+///  セルには交点なし(交点座標1.0,境界ID0)を返す.
+///
+///  密な交点情報配列(CalcCutInfoの結果,またはCalcCutInfoStreamingで
+///  スラブ毎に渡される配列)からz方向に昇順でappendして構築する.
+///
+template<typename CUT_POS, typename CUT_BID>
+class CutSparseInfoArrayTemplate : public CutInfoArray {
+
+  /// アクティブセルの交点情報レコード.
+  struct Record {
+    CUT_POS pos;  ///< 交点座標
+    CUT_BID bid;  ///< 境界ID
+  };
+
+  std::vector<size_t> index;     ///< アクティブセルの一次元インデクス(昇順)
+  std::vector<Record> records;   ///< アクティブセルの交点情報
+  int appendEnd;                 ///< 前回appendしたz方向範囲の終了位置(k1)
+
+public:
+  /// コンストラクタ.
+  ///
+  ///  @param[in] nx,ny,nz  配列サイズ(3次元で指定)
+  ///
+  CutSparseInfoArrayTemplate(size_t nx, size_t ny, size_t nz)
+    : CutInfoArray(nx, ny, nz), appendEnd(getStartZ()) {}
+
+  /// コンストラクタ.
+  ///
+  ///  @param[in] sx,sy,sz 領域開始位置3次元インデクス
+  ///  @param[in] ex,ey,ez 領域終了位置3次元インデクス
+  ///
+  CutSparseInfoArrayTemplate(int sx, int sy, int sz, int ex, int ey, int ez)
+    : CutInfoArray(sx, sy, sz, ex, ey, ez), appendEnd(getStartZ()) {}
+
+  /// コンストラクタ.
+  ///
+  ///  @param[in] ndim  配列サイズ(3次元で指定)
+  ///
+  CutSparseInfoArrayTemplate(const size_t ndim[])
+    : CutInfoArray(ndim[0], ndim[1], ndim[2]), appendEnd(getStartZ()) {}
+
+  /// デストラクタ.
+  ~CutSparseInfoArrayTemplate() {}
+
+  /// 一要素(アクティブセル1個)のバイトサイズを得る.
+  size_t getElementSize() const { return sizeof(size_t) + sizeof(Record); }
+
+  /// 全データをクリア(アクティブセルなし).
+  void clear() {
+    index.clear();
+    records.clear();
+    appendEnd = getStartZ();
+  }
+
+  /// 密な交点情報配列からz方向範囲[k0,k1)のアクティブセルを追加.
+  ///
+  ///  x,y方向は本配列の全範囲を走査する.
+  ///  一次元インデクスの昇順を保つため，k0は前回追加したk1以上であること
+  ///
+  ///  @param[in] cutPos 交点座標配列ラッパ
+  ///  @param[in] cutBid 境界ID配列ラッパ
+  ///  @param[in] k0,k1 z方向範囲
+  ///  @return k0が前回のk1(初回はz方向開始位置)より小さい，
+  ///          またはk1<k0の時はfalse(何も追加しない)
+  ///
+  bool append(const CutPosArray* cutPos, const CutBidArray* cutBid,
+              int k0, int k1) {
+    if (k0 < appendEnd || k1 < k0) return false;
+    appendEnd = k1;
+
+    // 同じ基本型の配列からは量子化し直さずにそのままコピー
+    const CutPosArrayTemplate<CUT_POS>* rawPos
+      = dynamic_cast<const CutPosArrayTemplate<CUT_POS>*>(cutPos);
+    const CutBidArrayTemplate<CUT_BID>* rawBid
+      = dynamic_cast<const CutBidArrayTemplate<CUT_BID>*>(cutBid);
+
+    int i0 = getStartX(), i1 = getStartX() + (int)getSizeX();
+    int j0 = getStartY(), j1 = getStartY() + (int)getSizeY();
+    for (int k = k0; k < k1; k++) {
+      for (int j = j0; j < j1; j++) {
+        for (int i = i0; i < i1; i++) {
+          BidType bid[6];
+          cutBid->getBid(i, j, k, bid);
+          if ((bid[0] | bid[1] | bid[2] | bid[3] | bid[4] | bid[5]) == 0) continue;
+          Record r;
+          if (rawPos) {
+            memcpy(&r.pos, rawPos->getDataPointer() + cutPos->getIndex(i, j, k),
+                   sizeof(CUT_POS));
+          } else {
+            float pos[6];
+            cutPos->getPos(i, j, k, pos);
+            SetCutPos(r.pos, pos);
+          }
+          if (rawBid) {
+            memcpy(&r.bid, rawBid->getDataPointer() + cutBid->getIndex(i, j, k),
+                   sizeof(CUT_BID));
+          } else {
+            ClearCutBid(r.bid);
+            SetCutBid(r.bid, bid);
+          }
+          index.push_back(getIndex(i, j, k));
+          records.push_back(r);
+        }
+      }
+    }
+    return true;
+  }
+
+  /// 密な交点情報配列の全領域から構築.
+  ///
+  ///  @param[in] cutPos 交点座標配列ラッパ
+  ///  @param[in] cutBid 境界ID配列ラッパ
+  ///
+  void build(const CutPosArray* cutPos, const CutBidArray* cutBid) {
+    clear();
+    append(cutPos, cutBid, getStartZ(), getStartZ() + (int)getSizeZ());
+  }
+
+  /// 一次元インデクスijkのアクティブセル番号を得る.
+  ///
+  ///  @param[in] ijk 1次元インデックス
+  ///  @return アクティブセル番号(アクティブでない時は-1)
+  ///
+  long findActive(size_t ijk) const {
+    std::vector<size_t>::const_iterator it
+      = std::lower_bound(index.begin(), index.end(), ijk);
+    if (it == index.end() || *it != ijk) return -1;
+    return it - index.begin();
+  }
+
+  /// 交点座標値(d方向)を得る.
+  float getPos(int i, int j, int k, int d) const {
+    return getPos(getIndex(i, j, k), d);
+  }
+
+  /// 交点座標値(d方向)を得る(1次元インデックスで指定).
+  float getPos(size_t ijk, int d) const {
+    long n = findActive(ijk);
+    return n < 0 ? 1.0f : GetCutPos(records[n].pos, d);
+  }
+
+  /// 交点座標値(6方向まとめて)を得る.
+  void getPos(int i, int j, int k, float pos[]) const {
+    getPos(getIndex(i, j, k), pos);
+  }
+
+  /// 交点座標値(6方向まとめて)を得る(1次元インデックスで指定).
+  void getPos(size_t ijk, float pos[]) const {
+    long n = findActive(ijk);
+    if (n < 0) {
+      for (int d = 0; d < 6; d++) pos[d] = 1.0f;
+    } else {
+      GetCutPos(records[n].pos, pos);
+    }
+  }
+
+  /// 境界ID(d方向)を得る.
+  BidType getBid(int i, int j, int k, int d) const {
+    return getBid(getIndex(i, j, k), d);
+  }
+
+  /// 境界ID(d方向)を得る(1次元インデックスで指定).
+  BidType getBid(size_t ijk, int d) const {
+    long n = findActive(ijk);
+    return n < 0 ? 0 : GetCutBid(records[n].bid, d);
+  }
+
+  /// 境界ID(6方向まとめて)を得る.
+  void getBid(int i, int j, int k, BidType bid[]) const {
+    getBid(getIndex(i, j, k), bid);
+  }
+
+  /// 境界ID(6方向まとめて)を得る(1次元インデックスで指定).
+  void getBid(size_t ijk, BidType bid[]) const {
+    long n = findActive(ijk);
+    if (n < 0) {
+      for (int d = 0; d < 6; d++) bid[d] = 0;
+    } else {
+      GetCutBid(records[n].bid, bid);
+    }
+  }
+
+  /// アクティブセル数を得る.
+  size_t getNumActive() const { return index.size(); }
+
+  /// アクティブセル番号nの一次元インデクスを得る.
+  size_t getActiveIndex(size_t n) const { return index[n]; }
+
+  /// アクティブセル番号nの3次元インデクスを得る.
+  ///
+  ///  @return データ配置がCL_LAYOUT_LINEAR以外の時はfalse(i,j,kは変更しない)
+  ///
+  bool getActiveIndex(size_t n, int& i, int& j, int& k) const {
+    if (getLayout() != CL_LAYOUT_LINEAR) return false;
+    size_t ijk = index[n];
+    i = getStartX() + (int)(ijk % getSizeX());
+    j = getStartY() + (int)((ijk / getSizeX()) % getSizeY());
+    k = getStartZ() + (int)(ijk / (getSizeX() * getSizeY()));
+    return true;
+  }
+
+  /// アクティブセル番号nの交点座標値(d方向)を得る.
+  float getActivePos(size_t n, int d) const {
+    return GetCutPos(records[n].pos, d);
+  }
+
+  /// アクティブセル番号nの交点座標値(6方向まとめて)を得る.
+  void getActivePos(size_t n, float pos[]) const {
+    GetCutPos(records[n].pos, pos);
+  }
+
+  /// アクティブセル番号nの境界ID(d方向)を得る.
+  BidType getActiveBid(size_t n, int d) const {
+    return GetCutBid(records[n].bid, d);
+  }
+
+  /// アクティブセル番号nの境界ID(6方向まとめて)を得る.
+  void getActiveBid(size_t n, BidType bid[]) const {
+    GetCutBid(records[n].bid, bid);
+  }
+
+  /// アクティブセルの一次元インデクス配列へのポインタを得る.
+  const size_t* getActiveIndexPointer() const {
+    return index.empty() ? 0 : &index[0];
+  }
+
+  /// 使用メモリ量(バイト)を得る.
+  size_t getMemorySize() const {
+    return index.capacity() * sizeof(size_t) + records.capacity() * sizeof(Record);
+  }
+
+};
+
+//-----------------------------------------------------------------------------
+
+/// CutPos32,CutBid8型交点情報疎配列クラス.
+typedef CutSparseInfoArrayTemplate<CutPos32, CutBid8> CutSparse32Array;
+
+/// CutPos8,CutBid5型交点情報疎配列クラス.
+typedef CutSparseInfoArrayTemplate<CutPos8, CutBid5> CutSparse8Array;
+
+//@} end group CutSparseInfoArray
+
+} // namespace cutlib
+
+#endif // CUTINFO_SPARSE_ARRAY_H
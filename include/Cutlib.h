@@ -31,6 +31,7 @@ using namespace Vec3class;
 
 #include "CutInfo/CutInfoArray.h"
 #include "CutInfo/CutNormalArray.h"
+#include "CutInfo/CutSparseInfoArray.h"
 #include "GridAccessor/GridAccessor.h"
 
 #ifdef CUTLIB_OCTREE
@@ -57,6 +58,18 @@ enum CutlibReturn {
 };
 
 
+class CutContext;  // CutContext.h
+
+
+/// 交点計算エンジン.
+enum CutlibEngine {
+  CL_ENGINE_CELL = 0,      ///< セル毎に6方向の計算基準線分を調査
+  CL_ENGINE_SCANLINE = 1,  ///< 格子線毎に交点を求め，線上の各セルに振り分け
+  CL_ENGINE_SCATTER = 2,   ///< 三角形毎に交点を求め，近傍セルに振り分け(疎な形状向け)
+  CL_ENGINE_BVH = 3,       ///< セル毎の探索にBVHを使用(三角形密度の偏りが大きい形状向け)
+};
+
+
 /// 交点情報計算: 計算領域指定.
 ///
 ///  @param[in] ista 計算基準点開始位置3次元インデクス
@@ -66,11 +79,13 @@ enum CutlibReturn {
 ///  @param[in,out] cutPos 交点座標配列ラッパ
 ///  @param[in,out] cutBid 境界ID配列ラッパ
 ///  @param[in,out] cutNormal 法線ベクトル格納クラス
+///  @param[in] engine 交点計算エンジン
 ///
 CutlibReturn CalcCutInfo(const int ista[], const size_t nlen[],
                          const GridAccessor* grid, const Polylib* pl,
                          CutPosArray* cutPos, CutBidArray* cutBid,
-                         CutNormalArray* cutNormal = 0);
+                         CutNormalArray* cutNormal = 0,
+                         CutlibEngine engine = CL_ENGINE_CELL);
 
 
 /// 交点情報計算: 全領域.
@@ -80,11 +95,13 @@ CutlibReturn CalcCutInfo(const int ista[], const size_t nlen[],
 ///  @param[in,out] cutPos 交点座標配列ラッパ
 ///  @param[in,out] cutBid 境界ID配列ラッパ
 ///  @param[in,out] cutNormal 法線ベクトル格納クラス
+///  @param[in] engine 交点計算エンジン
 ///
 inline
 CutlibReturn CalcCutInfo(const GridAccessor* grid, const Polylib* pl,
                          CutPosArray* cutPos, CutBidArray* cutBid,
-                         CutNormalArray* cutNormal = 0) {
+                         CutNormalArray* cutNormal = 0,
+                         CutlibEngine engine = CL_ENGINE_CELL) {
   int ista[3] = {
     cutPos->getStartX(),
     cutPos->getStartY(),
@@ -95,7 +112,7 @@ CutlibReturn CalcCutInfo(const GridAccessor* grid, const Polylib* pl,
     cutPos->getSizeY(),
     cutPos->getSizeZ()
   };
-  return CalcCutInfo(ista, nlen, grid, pl, cutPos, cutBid, cutNormal);
+  return CalcCutInfo(ista, nlen, grid, pl, cutPos, cutBid, cutNormal, engine);
 }
 
 
@@ -109,12 +126,14 @@ CutlibReturn CalcCutInfo(const GridAccessor* grid, const Polylib* pl,
 ///  @param[in,out] cutPos 交点座標配列ラッパ
 ///  @param[in,out] cutBid 境界ID配列ラッパ
 ///  @param[in,out] cutNormal 法線ベクトル格納クラス
+///  @param[in] engine 交点計算エンジン
 ///
 CutlibReturn CalcCutInfo(const int ista[], const size_t nlen[],
                          const GridAccessor* grid,
 												 const Polylib* pl, std::vector<std::string>* pgList,
                          CutPosArray* cutPos, CutBidArray* cutBid,
-                         CutNormalArray* cutNormal = 0);
+                         CutNormalArray* cutNormal = 0,
+                         CutlibEngine engine = CL_ENGINE_CELL);
 
 
 /// 交点情報計算: 全領域.
@@ -125,12 +144,14 @@ CutlibReturn CalcCutInfo(const int ista[], const size_t nlen[],
 ///  @param[in,out] cutPos 交点座標配列ラッパ
 ///  @param[in,out] cutBid 境界ID配列ラッパ
 ///  @param[in,out] cutNormal 法線ベクトル格納クラス
+///  @param[in] engine 交点計算エンジン
 ///
 inline
 CutlibReturn CalcCutInfo(const GridAccessor* grid,
 												 const Polylib* pl, std::vector<std::string>* pgList,
                          CutPosArray* cutPos, CutBidArray* cutBid,
-                         CutNormalArray* cutNormal = 0) {
+                         CutNormalArray* cutNormal = 0,
+                         CutlibEngine engine = CL_ENGINE_CELL) {
   int ista[3] = {
     cutPos->getStartX(),
     cutPos->getStartY(),
@@ -141,10 +162,134 @@ CutlibReturn CalcCutInfo(const GridAccessor* grid,
     cutPos->getSizeY(),
     cutPos->getSizeZ()
   };
-  return CalcCutInfo(ista, nlen, grid, pl, pgList, cutPos, cutBid, cutNormal);
+  return CalcCutInfo(ista, nlen, grid, pl, pgList, cutPos, cutBid, cutNormal,
+                     engine);
 }
 
 
+/// 交点情報計算: 計算領域指定, コンテキスト使用.
+///
+///  計算対象三角形ポリゴン等をコンテキストから再利用する
+///
+///  @param[in] ista 計算基準点開始位置3次元インデクス
+///  @param[in] nlen 計算基準点3次元サイズ
+///  @param[in] grid GridAccessorクラスオブジェクト
+///  @param[in,out] ctx 交点情報計算コンテキスト
+///  @param[in,out] cutPos 交点座標配列ラッパ
+///  @param[in,out] cutBid 境界ID配列ラッパ
+///  @param[in,out] cutNormal 法線ベクトル格納クラス
+///  @param[in] engine 交点計算エンジン
+///
+CutlibReturn CalcCutInfo(const int ista[], const size_t nlen[],
+                         const GridAccessor* grid, CutContext* ctx,
+                         CutPosArray* cutPos, CutBidArray* cutBid,
+                         CutNormalArray* cutNormal = 0,
+                         CutlibEngine engine = CL_ENGINE_CELL);
+
+
+/// 交点情報計算: 全領域, コンテキスト使用.
+///
+///  @param[in] grid GridAccessorクラスオブジェクト
+///  @param[in,out] ctx 交点情報計算コンテキスト
+///  @param[in,out] cutPos 交点座標配列ラッパ
+///  @param[in,out] cutBid 境界ID配列ラッパ
+///  @param[in,out] cutNormal 法線ベクトル格納クラス
+///  @param[in] engine 交点計算エンジン
+///
+inline
+CutlibReturn CalcCutInfo(const GridAccessor* grid, CutContext* ctx,
+                         CutPosArray* cutPos, CutBidArray* cutBid,
+                         CutNormalArray* cutNormal = 0,
+                         CutlibEngine engine = CL_ENGINE_CELL) {
+  int ista[3] = {
+    cutPos->getStartX(),
+    cutPos->getStartY(),
+    cutPos->getStartZ(),
+  };
+  size_t nlen[3] = {
+    cutPos->getSizeX(),
+    cutPos->getSizeY(),
+    cutPos->getSizeZ()
+  };
+  return CalcCutInfo(ista, nlen, grid, ctx, cutPos, cutBid, cutNormal, engine);
+}
+
+
+/// スラブ単位交点情報受け取りクラス(CalcCutInfoStreaming用).
+///
+///  利用者はこのクラスを継承し，processSlabで計算済みスラブの
+///  交点情報を書き出す等の処理を行う.
+///
+class CutSlabHandler {
+public:
+  /// デストラクタ.
+  virtual ~CutSlabHandler() {}
+
+  /// スラブの交点情報が確定した時に呼ばれる.
+  ///
+  ///  渡された配列の開始位置はz方向がk0に設定されている.
+  ///  配列は次のスラブで再利用されるため，呼び出し終了後は参照しないこと
+  ///
+  ///  @param[in] k0,k1 スラブのz方向範囲[k0,k1)
+  ///  @param[in] cutPos 交点座標配列ラッパ
+  ///  @param[in] cutBid 境界ID配列ラッパ
+  ///  @param[in] cutNormal 法線ベクトル格納クラス(法線を計算しない時は0)
+  ///
+  virtual void processSlab(int k0, int k1, const CutPosArray* cutPos,
+                           const CutBidArray* cutBid,
+                           const CutNormalArray* cutNormal) = 0;
+};
+
+
+/// 交点情報計算: z方向スラブ単位のストリーミング計算.
+///
+///  計算領域をz方向にslabDepth層ずつのスラブに分け，スラブ毎に
+///  交点情報を計算してhandlerに渡す.
+///  cutPos,cutBid,cutNormalはスラブ1枚分(x,y方向は計算領域を含み，
+///  z方向サイズslabDepth以上)の配列で，全スラブで再利用する.
+///  三角形ポリゴンの収集,BVHの構築は最初に一度だけ行う.
+///
+///  @param[in] ista 計算基準点開始位置3次元インデクス
+///  @param[in] nlen 計算基準点3次元サイズ
+///  @param[in] grid GridAccessorクラスオブジェクト
+///  @param[in] pl Polylibクラスオブジェクト
+///  @param[in] handler スラブ単位交点情報受け取りクラス
+///  @param[in] slabDepth スラブのz方向セル数
+///  @param[in,out] cutPos スラブ用交点座標配列ラッパ
+///  @param[in,out] cutBid スラブ用境界ID配列ラッパ
+///  @param[in,out] cutNormal スラブ用法線ベクトル格納クラス
+///  @param[in] engine 交点計算エンジン
+///
+///  @note 各配列のz方向開始位置は呼び出し中に変更される
+///
+CutlibReturn CalcCutInfoStreaming(const int ista[], const size_t nlen[],
+                                  const GridAccessor* grid, const Polylib* pl,
+                                  CutSlabHandler* handler, int slabDepth,
+                                  CutPosArray* cutPos, CutBidArray* cutBid,
+                                  CutNormalArray* cutNormal = 0,
+                                  CutlibEngine engine = CL_ENGINE_CELL);
+
+
+/// 交点情報計算: z方向スラブ単位のストリーミング計算, コンテキスト使用.
+///
+///  @param[in] ista 計算基準点開始位置3次元インデクス
+///  @param[in] nlen 計算基準点3次元サイズ
+///  @param[in] grid GridAccessorクラスオブジェクト
+///  @param[in,out] ctx 交点情報計算コンテキスト
+///  @param[in] handler スラブ単位交点情報受け取りクラス
+///  @param[in] slabDepth スラブのz方向セル数
+///  @param[in,out] cutPos スラブ用交点座標配列ラッパ
+///  @param[in,out] cutBid スラブ用境界ID配列ラッパ
+///  @param[in,out] cutNormal スラブ用法線ベクトル格納クラス
+///  @param[in] engine 交点計算エンジン
+///
+CutlibReturn CalcCutInfoStreaming(const int ista[], const size_t nlen[],
+                                  const GridAccessor* grid, CutContext* ctx,
+                                  CutSlabHandler* handler, int slabDepth,
+                                  CutPosArray* cutPos, CutBidArray* cutBid,
+                                  CutNormalArray* cutNormal = 0,
+                                  CutlibEngine engine = CL_ENGINE_CELL);
+
 #ifdef CUTLIB_OCTREE
 
 /// 交点情報計算: Octree, リーフセルのみ.
@@ -160,6 +305,8 @@ CutlibReturn CalcCutInfoOctreeLeafCell(SklTree* tree, const Polylib* pl,
 
 /// 交点情報計算: Octree, 全セル計算.
 ///
+/// ルートセル毎の三角形ポリゴン収集にはBVHを使用
+///
 ///  @param[in,out] tree SklTreeクラスオブジェクト
 ///  @param[in] pl Polylibクラスオブジェクト
 ///  @param cutPos 交点座標データアクセッサ
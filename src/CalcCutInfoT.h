@@ -0,0 +1,401 @@
+/*
+###################################################################################
+#
+# Cutlib - Cut Information Library
+#
+# Copyright (c) 2010-2011 VCAD System Research Program, RIKEN.
+# All rights reserved.
+#
+# Copyright (c) 2012-2015 Advanced Institute for Computational Science, RIKEN.
+# All rights reserved.
+#
+# Copyright (c) 2016-2017 Research Institute for Information Technology (RIIT), Kyushu University.
+# All rights reserved.
+#
+###################################################################################
+*/
+
+/// @file
+/// @brief 交点情報計算メインループ(型特殊化版)
+///
+///  グリッドアクセッサ,交点情報配列の具象型をテンプレート引数とし，
+///  セル毎の仮想関数呼び出しを静的呼び出しに置き換える.
+///
+
+#ifndef CUTLIB_CALC_CUT_INFO_T_H
+#define CUTLIB_CALC_CUT_INFO_T_H
+
+#include <typeinfo>
+
+#include "Cutlib.h"
+#include "CutSearch.h"
+#include "CutWorkPartition.h"
+#include "GridAccessor/Cell.h"
+#include "GridAccessor/Node.h"
+
+#ifdef CUTLIB_TIMING
+#include "CutTiming.h"
+#endif
+
+#ifdef _OPENMP
+#include "omp.h"
+#endif
+
+namespace cutlib {
+
+/// 具象型が分かっている時に仮想関数を静的に呼び出すための関数群.
+///
+///  基底クラス型の引数に対しては通常の仮想関数呼び出しとなる
+///
+struct CutStaticCall {
+
+  static void getSearchRange(const GridAccessor* grid, int i, int j, int k,
+                             double center[], double range[]) {
+    grid->getSearchRange(i, j, k, center, range);
+  }
+
+  static void getSearchRange(const Cell* grid, int i, int j, int k,
+                             double center[], double range[]) {
+    grid->Cell::getSearchRange(i, j, k, center, range);
+  }
+
+  static void getSearchRange(const Node* grid, int i, int j, int k,
+                             double center[], double range[]) {
+    grid->Node::getSearchRange(i, j, k, center, range);
+  }
+
+  static void setPos(CutPosArray* cutPos, int i, int j, int k, const float pos[]) {
+    cutPos->setPos(i, j, k, pos);
+  }
+
+  template <typename CUT_POS>
+  static void setPos(CutPosArrayTemplate<CUT_POS>* cutPos,
+                     int i, int j, int k, const float pos[]) {
+    cutPos->CutPosArrayTemplate<CUT_POS>::setPos(i, j, k, pos);
+  }
+
+  static void setBid(CutBidArray* cutBid, int i, int j, int k, const BidType bid[]) {
+    cutBid->setBid(i, j, k, bid);
+  }
+
+  template <typename CUT_BID>
+  static void setBid(CutBidArrayTemplate<CUT_BID>* cutBid,
+                     int i, int j, int k, const BidType bid[]) {
+    cutBid->CutBidArrayTemplate<CUT_BID>::setBid(i, j, k, bid);
+  }
+
+  /// 一次元データ領域を持つ具象型か(3次元インデクス範囲でクリアできるか).
+  static bool isDense(const CutPosArray*) { return false; }
+
+  template <typename CUT_POS>
+  static bool isDense(const CutPosArrayTemplate<CUT_POS>*) { return true; }
+
+  static bool isDense(const CutBidArray*) { return false; }
+
+  template <typename CUT_BID>
+  static bool isDense(const CutBidArrayTemplate<CUT_BID>*) { return true; }
+
+  static void clear(CutPosArray* cutPos, const int s[], const int e[]) {
+    const float pos[6] = { 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f };
+    for (int k = s[2]; k < e[2]; k++) {
+      for (int j = s[1]; j < e[1]; j++) {
+        for (int i = s[0]; i < e[0]; i++) cutPos->setPos(i, j, k, pos);
+      }
+    }
+  }
+
+  template <typename CUT_POS>
+  static void clear(CutPosArrayTemplate<CUT_POS>* cutPos,
+                    const int s[], const int e[]) {
+    cutPos->CutPosArrayTemplate<CUT_POS>::clear(s, e);
+  }
+
+  static void clear(CutBidArray* cutBid, const int s[], const int e[]) {
+    const BidType bid[6] = { 0, 0, 0, 0, 0, 0 };
+    for (int k = s[2]; k < e[2]; k++) {
+      for (int j = s[1]; j < e[1]; j++) {
+        for (int i = s[0]; i < e[0]; i++) cutBid->setBid(i, j, k, bid);
+      }
+    }
+  }
+
+  template <typename CUT_BID>
+  static void clear(CutBidArrayTemplate<CUT_BID>* cutBid,
+                    const int s[], const int e[]) {
+    cutBid->CutBidArrayTemplate<CUT_BID>::clear(s, e);
+  }
+
+};
+
+
+/// 交点情報配列をワークブロック単位でクリアできるか.
+///
+///  一次元データ領域を持つ具象型で，配列領域が計算領域と一致し，
+///  タイル配置の切り上げによる余白がない時に限る
+///
+///  @param[in] ista 計算基準点開始位置3次元インデクス
+///  @param[in] nlen 計算基準点3次元サイズ
+///  @param[in] array 交点座標配列または境界ID配列(具象型)
+///
+template <typename CUT_INFO_ARRAY>
+inline bool IsPartClearableT(const int ista[], const size_t nlen[],
+                             const CUT_INFO_ARRAY* array)
+{
+  return CutStaticCall::isDense(array)
+      && array->getStartX() == ista[0] && array->getSizeX() == nlen[0]
+      && array->getStartY() == ista[1] && array->getSizeY() == nlen[1]
+      && array->getStartZ() == ista[2] && array->getSizeZ() == nlen[2]
+      && array->getStorageSize() == nlen[0] * nlen[1] * nlen[2];
+}
+
+
+/// セル(i,j,k)の交点情報を計算.
+///
+///  @param[in] i,j,k 3次元インデクス
+///  @param[in] grid グリッドアクセッサ(具象型)
+///  @param[in] cutSearch 交点情報計算クラス
+///  @param[in,out] cutPos 交点座標配列(具象型)
+///  @param[in,out] cutBid 境界ID配列(具象型)
+///  @param[in] cutNormal 法線ベクトル格納クラス(0の時は交点ポリゴンを収集しない)
+///  @param[in,out] cutPolygonList 実行スレッドの交点ポリゴンリスト(cutNormal=0の時は0)
+///
+template <typename GRID, typename CUT_POS_ARRAY, typename CUT_BID_ARRAY>
+inline void CalcCutInfoCellT(int i, int j, int k, const GRID* grid,
+                             const CutSearch* cutSearch,
+                             CUT_POS_ARRAY* cutPos, CUT_BID_ARRAY* cutBid,
+                             const CutNormalArray* cutNormal,
+                             CutPolygonList* cutPolygonList)
+{
+  double pos6[6];
+  float pos6_f[6];
+  BidType bid6[6];
+  Triangle* tri6[6];
+  double center[3];
+  double range[6];
+
+#ifdef CUTLIB_TIMING
+  Timer::Start(THREAD_TOTAL);
+#endif
+  CutStaticCall::getSearchRange(grid, i, j, k, center, range);
+  cutSearch->search(i, j, k, center, range, pos6, bid6, tri6);
+
+  for (int d = 0; d < 6; d++) pos6_f[d] = (float)(pos6[d]/range[d]);
+
+  CutStaticCall::setPos(cutPos, i, j, k, pos6_f);
+  CutStaticCall::setBid(cutBid, i, j, k, bid6);
+
+  if (cutNormal) {
+    for (int d = 0; d < 6; d++) {
+      if (bid6[d] > 0) {
+        cutPolygonList->push_back(
+          CutPolygon(cutNormal->getIndex(i, j, k), d, tri6[d]));
+      }
+    }
+  }
+
+#ifdef CUTLIB_TIMING
+  Timer::Stop(THREAD_TOTAL);
+#endif
+}
+
+
+/// 交点情報計算メインループ(セル毎探索).
+///
+///  交点座標配列,境界ID配列は先頭でクリアする.
+///  partitionを指定した場合はワークブロックを番号順に連続した組として
+///  静的にスレッドに割り当て，占有されていないブリックの探索を省略する
+///  (交点情報はクリアした値のまま).
+///  クリアも同じ割り当てでワークブロック単位に行うため(IsPartClearableT参照)，
+///  各ページはそのワークブロックを探索するスレッドのNUMAノードに配置される.
+///  ブリック内はタイル配置(CutInfoLayout)の格納順に走査する
+///
+///  @param[in] ista 計算基準点開始位置3次元インデクス
+///  @param[in] nlen 計算基準点3次元サイズ
+///  @param[in] grid グリッドアクセッサ(具象型)
+///  @param[in] cutSearch 交点情報計算クラス
+///  @param[in] partition 負荷分散ブロック分割(0の時は(k,j)行単位で全セルを探索)
+///  @param[in,out] cutPos 交点座標配列(具象型)
+///  @param[in,out] cutBid 境界ID配列(具象型)
+///  @param[in] cutNormal 法線ベクトル格納クラス(0の時は交点ポリゴンを収集しない)
+///  @param[in,out] cutPolygonList スレッド毎の交点ポリゴンリスト(cutNormal=0の時は0)
+///
+template <typename GRID, typename CUT_POS_ARRAY, typename CUT_BID_ARRAY>
+void CalcCutInfoT(const int ista[], const size_t nlen[], const GRID* grid,
+                  const CutSearch* cutSearch, const CutWorkPartition* partition,
+                  CUT_POS_ARRAY* cutPos, CUT_BID_ARRAY* cutBid,
+                  const CutNormalArray* cutNormal,
+                  CutPolygonList* cutPolygonList)
+{
+  bool clearPart = partition && IsPartClearableT(ista, nlen, cutPos)
+                             && IsPartClearableT(ista, nlen, cutBid);
+  if (!clearPart) {
+    cutPos->clear();
+    cutBid->clear();
+  }
+
+  // 計算基準点終了位置の次(ループ上限はint型に揃える)
+  const int iend[3] = {
+    ista[0] + (int)nlen[0],
+    ista[1] + (int)nlen[1],
+    ista[2] + (int)nlen[2],
+  };
+
+#pragma omp parallel
+  {
+  int iThread;
+#ifdef _OPENMP
+  iThread = omp_get_thread_num();
+#else
+  iThread = 0;
+#endif
+  CutPolygonList* threadPolygonList = cutPolygonList ? &cutPolygonList[iThread]
+                                                     : 0;
+  if (partition) {
+    const CutOccupancy* occupancy = partition->getOccupancy();
+    // ブリックとタイルが一致する時はブリック内をMorton順に走査して
+    // 交点座標配列への書き込みを連続させる
+    bool morton = cutPos->getLayout() == CL_LAYOUT_MORTON
+               && occupancy->getBrickSize() == CutInfoArray::TileSize;
+    if (clearPart) {
+      // メインループと同じ静的割り当てでfirst touch
+#pragma omp for schedule(static)
+      for (int p = 0; p < partition->getNumPart(); p++) {
+        size_t bs[3], be[3];
+        partition->getPartRange(p, bs, be);
+        for (size_t bk = bs[2]; bk < be[2]; bk++) {
+        for (size_t bj = bs[1]; bj < be[1]; bj++) {
+        for (size_t bi = bs[0]; bi < be[0]; bi++) {
+          int s[3], e[3];
+          occupancy->getBrickRange(occupancy->getBrickIndex(bi, bj, bk), s, e);
+          CutStaticCall::clear(cutPos, s, e);
+          CutStaticCall::clear(cutBid, s, e);
+        }
+        }
+        }
+      }
+    }
+#pragma omp for schedule(static)
+    for (int p = 0; p < partition->getNumPart(); p++) {
+      size_t bs[3], be[3];
+      partition->getPartRange(p, bs, be);
+      for (size_t bk = bs[2]; bk < be[2]; bk++) {
+      for (size_t bj = bs[1]; bj < be[1]; bj++) {
+      for (size_t bi = bs[0]; bi < be[0]; bi++) {
+        size_t b = occupancy->getBrickIndex(bi, bj, bk);
+        if (!occupancy->isOccupied(b)) continue;
+        int s[3], e[3];
+        occupancy->getBrickRange(b, s, e);
+        if (morton) {
+          const size_t nTile = CutInfoArray::TileSize * CutInfoArray::TileSize
+                             * CutInfoArray::TileSize;
+          for (size_t m = 0; m < nTile; m++) {
+            int i, j, k;
+            CutInfoArray::MortonDecode(m, i, j, k);
+            i += s[0];
+            j += s[1];
+            k += s[2];
+            if (i >= e[0] || j >= e[1] || k >= e[2]) continue;
+            CalcCutInfoCellT(i, j, k, grid, cutSearch, cutPos, cutBid,
+                             cutNormal, threadPolygonList);
+          }
+          continue;
+        }
+        for (int k = s[2]; k < e[2]; k++) {
+          for (int j = s[1]; j < e[1]; j++) {
+            for (int i = s[0]; i < e[0]; i++) {
+              CalcCutInfoCellT(i, j, k, grid, cutSearch, cutPos, cutBid,
+                               cutNormal, threadPolygonList);
+            }
+          }
+        }
+      }
+      }
+      }
+    }
+  } else {
+#pragma omp for schedule(dynamic), collapse(2)
+    for (int k = ista[2]; k < iend[2]; k++) {
+      for (int j = ista[1]; j < iend[1]; j++) {
+        for (int i = ista[0]; i < iend[0]; i++) {
+          CalcCutInfoCellT(i, j, k, grid, cutSearch, cutPos, cutBid,
+                           cutNormal, threadPolygonList);
+        }
+      }
+    }
+  }
+  } // parallel region
+}
+
+
+/// 境界ID配列の具象型を判定してCalcCutInfoTを呼び出す.
+template <typename GRID, typename CUT_POS_ARRAY>
+void CalcCutInfoT(const int ista[], const size_t nlen[], const GRID* grid,
+                  const CutSearch* cutSearch, const CutWorkPartition* partition,
+                  CUT_POS_ARRAY* cutPos, CutBidArray* cutBid,
+                  const CutNormalArray* cutNormal,
+                  CutPolygonList* cutPolygonList)
+{
+  if (typeid(*cutBid) == typeid(CutBid5Array)) {
+    CalcCutInfoT(ista, nlen, grid, cutSearch, partition, cutPos,
+                 static_cast<CutBid5Array*>(cutBid), cutNormal, cutPolygonList);
+  } else if (typeid(*cutBid) == typeid(CutBid8Array)) {
+    CalcCutInfoT(ista, nlen, grid, cutSearch, partition, cutPos,
+                 static_cast<CutBid8Array*>(cutBid), cutNormal, cutPolygonList);
+  } else {
+    CalcCutInfoT<GRID, CUT_POS_ARRAY, CutBidArray>(ista, nlen, grid,
+                 cutSearch, partition, cutPos, cutBid, cutNormal, cutPolygonList);
+  }
+}
+
+
+/// 交点座標配列の具象型を判定してCalcCutInfoTを呼び出す.
+template <typename GRID>
+void CalcCutInfoT(const int ista[], const size_t nlen[], const GRID* grid,
+                  const CutSearch* cutSearch, const CutWorkPartition* partition,
+                  CutPosArray* cutPos, CutBidArray* cutBid,
+                  const CutNormalArray* cutNormal,
+                  CutPolygonList* cutPolygonList)
+{
+  if (typeid(*cutPos) == typeid(CutPos8Array)) {
+    CalcCutInfoT(ista, nlen, grid, cutSearch, partition,
+                 static_cast<CutPos8Array*>(cutPos), cutBid, cutNormal, cutPolygonList);
+  } else if (typeid(*cutPos) == typeid(CutPos32Array)) {
+    CalcCutInfoT(ista, nlen, grid, cutSearch, partition,
+                 static_cast<CutPos32Array*>(cutPos), cutBid, cutNormal, cutPolygonList);
+  } else if (typeid(*cutPos) == typeid(CutPos16Array)) {
+    CalcCutInfoT(ista, nlen, grid, cutSearch, partition,
+                 static_cast<CutPos16Array*>(cutPos), cutBid, cutNormal, cutPolygonList);
+  } else {
+    CalcCutInfoT<GRID, CutPosArray>(ista, nlen, grid, cutSearch, partition,
+                 cutPos, cutBid, cutNormal, cutPolygonList);
+  }
+}
+
+
+/// グリッドアクセッサ,交点情報配列の具象型を判定してCalcCutInfoTを呼び出す.
+///
+///  Cell/Node, CutPos32Array/CutPos16Array/CutPos8Array, CutBid8Array/CutBid5Arrayの
+///  組み合わせは特殊化版を，それ以外(派生クラスを含む)は仮想関数呼び出し版を使用
+///
+inline void CalcCutInfoT(const int ista[], const size_t nlen[],
+                         const GridAccessor* grid, const CutSearch* cutSearch,
+                         const CutWorkPartition* partition,
+                         CutPosArray* cutPos, CutBidArray* cutBid,
+                         const CutNormalArray* cutNormal,
+                         CutPolygonList* cutPolygonList)
+{
+  if (typeid(*grid) == typeid(Cell)) {
+    CalcCutInfoT(ista, nlen, static_cast<const Cell*>(grid), cutSearch,
+                 partition, cutPos, cutBid, cutNormal, cutPolygonList);
+  } else if (typeid(*grid) == typeid(Node)) {
+    CalcCutInfoT(ista, nlen, static_cast<const Node*>(grid), cutSearch,
+                 partition, cutPos, cutBid, cutNormal, cutPolygonList);
+  } else {
+    CalcCutInfoT<GridAccessor>(ista, nlen, grid, cutSearch, partition,
+                 cutPos, cutBid, cutNormal, cutPolygonList);
+  }
+}
+
+} // namespace cutlib
+
+#endif // CUTLIB_CALC_CUT_INFO_T_H
@@ -0,0 +1,136 @@
+/*
+###################################################################################
+#
+# Cutlib - Cut Information Library
+#
+# Copyright (c) 2010-2011 VCAD System Research Program, RIKEN.
+# All rights reserved.
+#
+# Copyright (c) 2012-2015 Advanced Institute for Computational Science, RIKEN.
+# All rights reserved.
+#
+# Copyright (c) 2016-2017 Research Institute for Information Technology (RIIT), Kyushu University.
+# All rights reserved.
+#
+###################################################################################
+*/
+
+/// @file
+/// @brief 三角形ポリゴン空間インデクスクラス 実装
+///
+
+#include "CutBinIndex.h"
+
+#include <algorithm>   // for min, max, lower_bound, upper_bound
+#ifdef CUTLIB_DEBUG
+#include <iostream>
+#endif
+
+namespace cutlib {
+
+/// コンストラクタ.
+///
+///  @param[in] lattice 計算対象領域の直交格子座標テーブル
+///  @param[in] store 計算対象三角形ポリゴン
+///  @param[in] binSize ブリック一辺のセル数
+///
+CutBinIndex::CutBinIndex(const CutGridLattice* lattice,
+                         const CutTriangleStore* store, int binSize)
+  : lattice(lattice), store(store), binSize(binSize)
+{
+  for (int a = 0; a < 3; a++) {
+    ista[a] = lattice->getStart(a);
+    nBin[a] = (lattice->getSize(a) + binSize - 1) / binSize;
+  }
+
+  setBinRange();
+  buildBins();
+
+#ifdef CUTLIB_DEBUG
+  std::cout << "CutBinIndex: " << nBin[X] * nBin[Y] * nBin[Z] << " bins, "
+            << binTri.size() << " entries" << std::endl;
+#endif
+}
+
+
+/// 各方向のブリック探索領域を計算.
+void CutBinIndex::setBinRange()
+{
+  for (int a = 0; a < 3; a++) {
+    binMin[a].resize(nBin[a]);
+    binMax[a].resize(nBin[a]);
+    for (size_t l = 0; l < lattice->getSize(a); l++) {
+      size_t b = l / binSize;
+      if (l % binSize == 0) {
+        binMin[a][b] = lattice->getBoxMin(a, l);
+        binMax[a][b] = lattice->getBoxMax(a, l);
+      } else {
+        binMin[a][b] = std::min(binMin[a][b], lattice->getBoxMin(a, l));
+        binMax[a][b] = std::max(binMax[a][b], lattice->getBoxMax(a, l));
+      }
+    }
+  }
+}
+
+
+/// 区間[min,max]と交わるブリックのa方向の範囲を得る.
+///
+///  @param[in] a 方向(X,Y,Z)
+///  @param[in] min,max 区間
+///  @param[out] b0,b1 ブリック範囲(b0 > b1の時は交わるブリックなし)
+///
+void CutBinIndex::findBinRange(int a, double min, double max,
+                               long& b0, long& b1) const
+{
+  b0 = std::lower_bound(binMax[a].begin(), binMax[a].end(), min)
+     - binMax[a].begin();
+  b1 = std::upper_bound(binMin[a].begin(), binMin[a].end(), max)
+     - binMin[a].begin() - 1;
+}
+
+
+/// ブリック毎の三角形番号リストを作成.
+///
+///  各ブリックのリスト内で三角形番号は昇順に並ぶ
+///
+void CutBinIndex::buildBins()
+{
+  size_t nBinAll = nBin[X] * nBin[Y] * nBin[Z];
+  binStart.assign(nBinAll + 1, 0);
+  if (nBinAll == 0) return;
+
+  int nTri = store->getNumTriangle();
+  std::vector<long> range(6 * nTri);
+
+  for (int t = 0; t < nTri; t++) {
+    long* r = &range[6*t];
+    for (int a = 0; a < 3; a++) {
+      findBinRange(a, store->getBBoxMin(t)[a], store->getBBoxMax(t)[a],
+                   r[2*a], r[2*a+1]);
+    }
+    for (long bk = r[4]; bk <= r[5]; bk++) {
+      for (long bj = r[2]; bj <= r[3]; bj++) {
+        for (long bi = r[0]; bi <= r[1]; bi++) {
+          binStart[bi + bj*nBin[X] + bk*nBin[X]*nBin[Y] + 1]++;
+        }
+      }
+    }
+  }
+
+  for (size_t b = 0; b < nBinAll; b++) binStart[b+1] += binStart[b];
+
+  binTri.resize(binStart[nBinAll]);
+  std::vector<size_t> pos(binStart.begin(), binStart.end() - 1);
+  for (int t = 0; t < nTri; t++) {
+    const long* r = &range[6*t];
+    for (long bk = r[4]; bk <= r[5]; bk++) {
+      for (long bj = r[2]; bj <= r[3]; bj++) {
+        for (long bi = r[0]; bi <= r[1]; bi++) {
+          binTri[pos[bi + bj*nBin[X] + bk*nBin[X]*nBin[Y]]++] = t;
+        }
+      }
+    }
+  }
+}
+
+} // namespace cutlib
@@ -0,0 +1,122 @@
+/*
+###################################################################################
+#
+# Cutlib - Cut Information Library
+#
+# Copyright (c) 2010-2011 VCAD System Research Program, RIKEN.
+# All rights reserved.
+#
+# Copyright (c) 2012-2015 Advanced Institute for Computational Science, RIKEN.
+# All rights reserved.
+#
+# Copyright (c) 2016-2017 Research Institute for Information Technology (RIIT), Kyushu University.
+# All rights reserved.
+#
+###################################################################################
+*/
+
+/// @file
+/// @brief 三角形ポリゴン空間インデクスクラス 宣言
+///
+
+#ifndef CUTLIB_BIN_INDEX_H
+#define CUTLIB_BIN_INDEX_H
+
+#include <vector>
+
+#include "CutGridLattice.h"
+#include "CutTriangleStore.h"
+
+#include "Polylib.h"
+using namespace PolylibNS;
+
+namespace cutlib {
+
+/// 三角形ポリゴン空間インデクスクラス(一様ブリック分割).
+///
+///  計算対象領域をbinSize^3セルのブリックに分割し，
+///  ブリック毎にその探索領域と交わる三角形ポリゴンのリストを保持する.
+///  CalcCutInfoの呼び出し毎に一度だけ構築し，セル毎の
+///  Polylib::search_polygons呼び出しを置き換える.
+///
+///  @note 直交格子を仮定(CutGridLattice参照).
+///        CutGridLattice::isSeparable()がfalseの時は使用しない
+///
+class CutBinIndex {
+
+  enum { X, Y, Z };
+
+  const CutGridLattice* lattice;  ///< 直交格子座標テーブル
+  const CutTriangleStore* store;  ///< 計算対象三角形ポリゴン
+  int ista[3];      ///< 計算基準点開始位置3次元インデクス
+  int binSize;      ///< ブリック一辺のセル数
+  size_t nBin[3];   ///< 各方向のブリック数
+
+  std::vector<double> binMin[3];  ///< 各方向のブリック探索領域最小値
+  std::vector<double> binMax[3];  ///< 各方向のブリック探索領域最大値
+
+  std::vector<size_t> binStart;  ///< ブリック毎の三角形番号リスト開始位置
+  std::vector<int> binTri;       ///< ブリック毎の三角形番号リスト(連結)
+
+public:
+
+  /// デフォルトのブリック一辺のセル数.
+  static const int DefaultBinSize = 4;
+
+  /// コンストラクタ.
+  ///
+  ///  @param[in] lattice 計算対象領域の直交格子座標テーブル
+  ///  @param[in] store 計算対象三角形ポリゴン
+  ///  @param[in] binSize ブリック一辺のセル数
+  ///
+  CutBinIndex(const CutGridLattice* lattice, const CutTriangleStore* store,
+              int binSize = DefaultBinSize);
+
+  /// デストラクタ.
+  ~CutBinIndex() {}
+
+  /// セル(i,j,k)を含むブリックの三角形番号リストを得る.
+  ///
+  ///  @param[in] i,j,k  3次元インデックス
+  ///  @param[out] first 三角形番号リスト先頭
+  ///  @param[out] last  三角形番号リスト末尾の次
+  ///
+  void getBin(int i, int j, int k, const int*& first, const int*& last) const {
+    size_t b = ((i - ista[X]) / binSize)
+             + ((j - ista[Y]) / binSize) * nBin[X]
+             + ((k - ista[Z]) / binSize) * nBin[X] * nBin[Y];
+    const int* p = binTri.empty() ? 0 : &binTri[0];
+    first = p + binStart[b];
+    last  = p + binStart[b+1];
+  }
+
+  /// ブリック一辺のセル数を得る.
+  int getBinSize() const { return binSize; }
+
+  /// 直交格子座標テーブルを得る.
+  const CutGridLattice* getLattice() const { return lattice; }
+
+  /// 計算対象三角形ポリゴンを得る.
+  const CutTriangleStore* getStore() const { return store; }
+
+private:
+
+  /// 各方向のブリック探索領域を計算.
+  void setBinRange();
+
+  /// ブリック毎の三角形番号リストを作成.
+  void buildBins();
+
+  /// 区間[min,max]と交わるブリックのa方向の範囲を得る.
+  ///
+  ///  @param[in] a 方向(X,Y,Z)
+  ///  @param[in] min,max 区間
+  ///  @param[out] b0,b1 ブリック範囲(b0 > b1の時は交わるブリックなし)
+  ///
+  void findBinRange(int a, double min, double max, long& b0, long& b1) const;
+
+};
+
+} // namespace cutlib
+
+#endif // CUTLIB_BIN_INDEX_H
@@ -0,0 +1,282 @@
+/*
+###################################################################################
+#
+# Cutlib - Cut Information Library
+#
+# Copyright (c) 2010-2011 VCAD System Research Program, RIKEN.
+# All rights reserved.
+#
+# Copyright (c) 2012-2015 Advanced Institute for Computational Science, RIKEN.
+# All rights reserved.
+#
+# Copyright (c) 2016-2017 Research Institute for Information Technology (RIIT), Kyushu University.
+# All rights reserved.
+#
+###################################################################################
+*/
+
+/// @file
+/// @brief 三角形ポリゴンBVHクラス 実装
+///
+
+#include "CutBvh.h"
+
+#include <algorithm>   // for min, max, partition
+#include <float.h>     // for FLT_MAX
+#include <math.h>      // for nextafterf
+#ifdef CUTLIB_DEBUG
+#include <iostream>
+#endif
+
+namespace cutlib {
+
+/// 構築用BVHノード.
+struct CutBvh::BuildNode {
+  double bmin[3];        ///< BBox最小値
+  double bmax[3];        ///< BBox最大値
+  BuildNode* child[2];   ///< 子ノード(葉の時は0)
+  int begin;             ///< 三角形番号リスト開始位置
+  int end;               ///< 三角形番号リスト終了位置の次
+};
+
+
+namespace {
+
+/// SAH評価のビン数.
+const int NumBin = 16;
+
+/// OpenMPタスクで構築する部分木の最小三角形数.
+const int TaskThreshold = 4096;
+
+/// 三角形がa方向の分割位置より前のビンに属するかの判定.
+struct SplitPredicate {
+  const CutTriangleStore* store;
+  int a;
+  double cmin;
+  double scale;
+  int split;
+
+  bool operator()(int t) const {
+    double c = 0.5 * (store->getBBoxMin(t)[a] + store->getBBoxMax(t)[a]);
+    int b = std::min(NumBin - 1, (int)((c - cmin) * scale));
+    return b < split;
+  }
+};
+
+/// BBoxの表面積.
+double area(const double bmin[], const double bmax[])
+{
+  double dx = bmax[0] - bmin[0];
+  double dy = bmax[1] - bmin[1];
+  double dz = bmax[2] - bmin[2];
+  return 2.0 * (dx * dy + dy * dz + dz * dx);
+}
+
+/// 単精度への切り下げ.
+float floatDown(double x)
+{
+  float f = (float)x;
+  return ((double)f > x) ? nextafterf(f, -FLT_MAX) : f;
+}
+
+/// 単精度への切り上げ.
+float floatUp(double x)
+{
+  float f = (float)x;
+  return ((double)f < x) ? nextafterf(f, FLT_MAX) : f;
+}
+
+} // namespace
+
+
+/// コンストラクタ.
+///
+///  @param[in] store 計算対象三角形ポリゴン
+///
+CutBvh::CutBvh(const CutTriangleStore* store) : store(store)
+{
+  int nTri = store->getNumTriangle();
+  if (nTri == 0) return;
+
+  triId.resize(nTri);
+  for (int t = 0; t < nTri; t++) triId[t] = t;
+
+  BuildNode* root = 0;
+#pragma omp parallel
+  {
+#pragma omp single
+  root = build(0, nTri, 0);
+  }
+
+  nodes.reserve(2 * nTri);
+  flatten(root);
+
+#ifdef CUTLIB_DEBUG
+  std::cout << "CutBvh: " << nTri << " triangles, "
+            << nodes.size() << " nodes" << std::endl;
+#endif
+}
+
+
+/// 三角形番号リストの区間[begin,end)について部分木を構築.
+///
+///  三角形BBoxの中心座標で各方向をNumBin個のビンに分け，SAHコストが
+///  最小となる分割を選ぶ. 葉とする方が安い時，または深さがMaxDepthに
+///  達した時は葉ノードとする
+///
+///  @param[in] begin,end 三角形番号リストの区間
+///  @param[in] depth 深さ
+///  @return 部分木のルートノード
+///
+CutBvh::BuildNode* CutBvh::build(int begin, int end, int depth)
+{
+  BuildNode* b = new BuildNode;
+  b->child[0] = b->child[1] = 0;
+  b->begin = begin;
+  b->end = end;
+
+  double cmin[3], cmax[3];
+  for (int a = 0; a < 3; a++) {
+    b->bmin[a] = cmin[a] =  DBL_MAX;
+    b->bmax[a] = cmax[a] = -DBL_MAX;
+  }
+  for (int i = begin; i < end; i++) {
+    const Vec3r& tMin = store->getBBoxMin(triId[i]);
+    const Vec3r& tMax = store->getBBoxMax(triId[i]);
+    for (int a = 0; a < 3; a++) {
+      double c = 0.5 * (tMin[a] + tMax[a]);
+      b->bmin[a] = std::min(b->bmin[a], (double)tMin[a]);
+      b->bmax[a] = std::max(b->bmax[a], (double)tMax[a]);
+      cmin[a] = std::min(cmin[a], c);
+      cmax[a] = std::max(cmax[a], c);
+    }
+  }
+
+  int n = end - begin;
+  if (n <= 2 || depth >= MaxDepth) return b;
+
+  // SAHによる分割位置の選択
+  double leafCost = n * area(b->bmin, b->bmax);
+  double bestCost = DBL_MAX;
+  int bestAxis = -1;
+  int bestSplit = 0;
+  for (int a = 0; a < 3; a++) {
+    if (!(cmax[a] > cmin[a])) continue;
+    double scale = NumBin / (cmax[a] - cmin[a]);
+
+    int count[NumBin];
+    double binMin[NumBin][3], binMax[NumBin][3];
+    for (int k = 0; k < NumBin; k++) {
+      count[k] = 0;
+      for (int l = 0; l < 3; l++) {
+        binMin[k][l] =  DBL_MAX;
+        binMax[k][l] = -DBL_MAX;
+      }
+    }
+    for (int i = begin; i < end; i++) {
+      const Vec3r& tMin = store->getBBoxMin(triId[i]);
+      const Vec3r& tMax = store->getBBoxMax(triId[i]);
+      double c = 0.5 * (tMin[a] + tMax[a]);
+      int k = std::min(NumBin - 1, (int)((c - cmin[a]) * scale));
+      count[k]++;
+      for (int l = 0; l < 3; l++) {
+        binMin[k][l] = std::min(binMin[k][l], (double)tMin[l]);
+        binMax[k][l] = std::max(binMax[k][l], (double)tMax[l]);
+      }
+    }
+
+    // 右側からの累積面積
+    double rightArea[NumBin];
+    int rightCount[NumBin];
+    double rMin[3] = { DBL_MAX, DBL_MAX, DBL_MAX };
+    double rMax[3] = { -DBL_MAX, -DBL_MAX, -DBL_MAX };
+    int rCount = 0;
+    for (int k = NumBin - 1; k > 0; k--) {
+      rCount += count[k];
+      for (int l = 0; l < 3; l++) {
+        rMin[l] = std::min(rMin[l], binMin[k][l]);
+        rMax[l] = std::max(rMax[l], binMax[k][l]);
+      }
+      rightCount[k] = rCount;
+      rightArea[k] = rCount > 0 ? area(rMin, rMax) : 0.0;
+    }
+
+    double lMin[3] = { DBL_MAX, DBL_MAX, DBL_MAX };
+    double lMax[3] = { -DBL_MAX, -DBL_MAX, -DBL_MAX };
+    int lCount = 0;
+    for (int k = 1; k < NumBin; k++) {
+      lCount += count[k-1];
+      for (int l = 0; l < 3; l++) {
+        lMin[l] = std::min(lMin[l], binMin[k-1][l]);
+        lMax[l] = std::max(lMax[l], binMax[k-1][l]);
+      }
+      if (lCount == 0 || rightCount[k] == 0) continue;
+      double cost = lCount * area(lMin, lMax) + rightCount[k] * rightArea[k];
+      if (cost < bestCost) {
+        bestCost = cost;
+        bestAxis = a;
+        bestSplit = k;
+      }
+    }
+  }
+
+  int mid = begin + n / 2;
+  if (bestAxis >= 0) {
+    if (bestCost >= leafCost && n <= MaxLeafSize) return b;
+    SplitPredicate pred;
+    pred.store = store;
+    pred.a = bestAxis;
+    pred.cmin = cmin[bestAxis];
+    pred.scale = NumBin / (cmax[bestAxis] - cmin[bestAxis]);
+    pred.split = bestSplit;
+    mid = std::partition(&triId[0] + begin, &triId[0] + end, pred) - &triId[0];
+    if (mid == begin || mid == end) mid = begin + n / 2;
+  } else {
+    // 中心座標が全て一致: 個数で二分
+    if (n <= MaxLeafSize) return b;
+  }
+
+  if (n > TaskThreshold) {
+#pragma omp task
+    b->child[0] = build(begin, mid, depth + 1);
+#pragma omp task
+    b->child[1] = build(mid, end, depth + 1);
+#pragma omp taskwait
+  } else {
+    b->child[0] = build(begin, mid, depth + 1);
+    b->child[1] = build(mid, end, depth + 1);
+  }
+
+  return b;
+}
+
+
+/// 部分木を深さ優先順にノード配列へ格納し，解放.
+///
+///  @param[in] b 部分木のルートノード
+///  @return 格納したノード番号
+///
+int CutBvh::flatten(BuildNode* b)
+{
+  int id = nodes.size();
+  nodes.push_back(Node());
+  for (int a = 0; a < 3; a++) {
+    nodes[id].bmin[a] = floatDown(b->bmin[a]);
+    nodes[id].bmax[a] = floatUp(b->bmax[a]);
+  }
+
+  if (b->child[0] == 0) {
+    nodes[id].offset = b->begin;
+    nodes[id].count = b->end - b->begin;
+  } else {
+    flatten(b->child[0]);
+    int right = flatten(b->child[1]);
+    nodes[id].offset = right;
+    nodes[id].count = 0;
+  }
+
+  delete b;
+  return id;
+}
+
+} // namespace cutlib
@@ -0,0 +1,141 @@
+/*
+###################################################################################
+#
+# Cutlib - Cut Information Library
+#
+# Copyright (c) 2010-2011 VCAD System Research Program, RIKEN.
+# All rights reserved.
+#
+# Copyright (c) 2012-2015 Advanced Institute for Computational Science, RIKEN.
+# All rights reserved.
+#
+# Copyright (c) 2016-2017 Research Institute for Information Technology (RIIT), Kyushu University.
+# All rights reserved.
+#
+###################################################################################
+*/
+
+/// @file
+/// @brief 三角形ポリゴンBVHクラス 宣言
+///
+
+#ifndef CUTLIB_BVH_H
+#define CUTLIB_BVH_H
+
+#include <vector>
+
+#include "CutTriangleStore.h"
+
+#include "Polylib.h"
+using namespace PolylibNS;
+
+namespace cutlib {
+
+/// 三角形ポリゴンBVH(Bounding Volume Hierarchy)クラス.
+///
+///  計算対象三角形ポリゴンのBBoxに対し，SAH(Surface Area Heuristic)による
+///  ビン分割で二分木を構築する. 三角形密度の偏りが大きい形状でも
+///  探索コストが一様ブリック分割のように悪化しない.
+///  構築は大きな部分木をOpenMPタスクで並列に行う.
+///  格子に依存しないため，格子や計算領域を変えた呼び出し間で再利用できる.
+///
+class CutBvh {
+
+  enum { X, Y, Z };
+
+public:
+
+  /// BVHノード(32バイト).
+  ///
+  ///  BBoxは単精度に外向きに丸めて保持する.
+  ///  内部ノードの左の子は直後のノード，右の子はoffset番目のノード.
+  ///  葉ノードの三角形は三角形番号リストのoffset番目からcount個.
+  ///
+  struct Node {
+    float bmin[3];  ///< BBox最小値
+    float bmax[3];  ///< BBox最大値
+    int offset;     ///< 右の子ノード番号(内部ノード)/三角形番号リスト開始位置(葉)
+    int count;      ///< 三角形数(0の時は内部ノード)
+  };
+
+  /// 葉ノードの最大三角形数.
+  static const int MaxLeafSize = 8;
+
+  /// 木の最大深さ(これを越える部分は葉ノードとする).
+  static const int MaxDepth = 64;
+
+private:
+
+  const CutTriangleStore* store;  ///< 計算対象三角形ポリゴン
+
+  std::vector<Node> nodes;  ///< ノード配列(深さ優先順)
+  std::vector<int> triId;   ///< 葉ノードの三角形番号リスト(連結)
+
+  struct BuildNode;
+
+public:
+
+  /// コンストラクタ.
+  ///
+  ///  @param[in] store 計算対象三角形ポリゴン
+  ///
+  CutBvh(const CutTriangleStore* store);
+
+  /// デストラクタ.
+  ~CutBvh() {}
+
+  /// 計算対象三角形ポリゴンを得る.
+  const CutTriangleStore* getStore() const { return store; }
+
+  /// ノード数を得る.
+  size_t getNumNode() const { return nodes.size(); }
+
+  /// 直方体領域と交わる葉ノードの三角形について関数オブジェクトを呼び出す.
+  ///
+  ///  @param[in] min,max 直方体頂点座標
+  ///  @param[in,out] f 関数オブジェクト(f(三角形番号)の形で呼び出す)
+  ///
+  ///  @note 三角形のBBoxと直方体領域の交差判定は行わない
+  ///
+  template <typename F>
+  void query(const Vec3r& min, const Vec3r& max, F& f) const {
+    if (nodes.empty()) return;
+    int stack[MaxDepth + 2];
+    int nStack = 0;
+    stack[nStack++] = 0;
+    while (nStack > 0) {
+      const Node& node = nodes[stack[--nStack]];
+      if (node.bmin[X] > max[X] || node.bmax[X] < min[X] ||
+          node.bmin[Y] > max[Y] || node.bmax[Y] < min[Y] ||
+          node.bmin[Z] > max[Z] || node.bmax[Z] < min[Z]) continue;
+      if (node.count > 0) {
+        for (int i = node.offset; i < node.offset + node.count; i++) f(triId[i]);
+      } else {
+        stack[nStack++] = node.offset;
+        stack[nStack++] = &node - &nodes[0] + 1;
+      }
+    }
+  }
+
+private:
+
+  /// 三角形番号リストの区間[begin,end)について部分木を構築.
+  ///
+  ///  @param[in] begin,end 三角形番号リストの区間
+  ///  @param[in] depth 深さ
+  ///  @return 部分木のルートノード
+  ///
+  BuildNode* build(int begin, int end, int depth);
+
+  /// 部分木を深さ優先順にノード配列へ格納し，解放.
+  ///
+  ///  @param[in] b 部分木のルートノード
+  ///  @return 格納したノード番号
+  ///
+  int flatten(BuildNode* b);
+
+};
+
+} // namespace cutlib
+
+#endif // CUTLIB_BVH_H
@@ -0,0 +1,121 @@
+/*
+###################################################################################
+#
+# Cutlib - Cut Information Library
+#
+# Copyright (c) 2010-2011 VCAD System Research Program, RIKEN.
+# All rights reserved.
+#
+# Copyright (c) 2012-2015 Advanced Institute for Computational Science, RIKEN.
+# All rights reserved.
+#
+# Copyright (c) 2016-2017 Research Institute for Information Technology (RIIT), Kyushu University.
+# All rights reserved.
+#
+###################################################################################
+*/
+
+
+/// @file
+/// @brief 交点情報計算コンテキストクラス 実装
+///
+
+#include "CutContext.h"
+#include "CutBvh.h"
+#include "CutTriangleStore.h"
+
+namespace cutlib {
+
+/// コンストラクタ(全ポリゴングループ).
+///
+///  @param[in] pl Polylibクラスオブジェクト
+///
+CutContext::CutContext(const Polylib* pl)
+  : pl(pl), store(0), bvh(0), cutPolygonList(0), nThread(0)
+{
+  if (pl == 0) return;
+  std::vector<PolygonGroup*>* leafGroups = pl->get_leaf_groups();
+  std::vector<PolygonGroup*>::iterator it;
+  for (it = leafGroups->begin(); it != leafGroups->end(); ++it) {
+    pgList.push_back((*it)->acq_fullpath());
+  }
+  delete leafGroups;
+}
+
+
+/// コンストラクタ(ポリゴングループ指定).
+///
+///  @param[in] pl Polylibクラスオブジェクト
+///  @param[in] pgList 計算対象ポリゴングループのパス名リスト
+///
+CutContext::CutContext(const Polylib* pl,
+                       const std::vector<std::string>& pgList)
+  : pl(pl), pgList(pgList), store(0), bvh(0), cutPolygonList(0), nThread(0)
+{
+}
+
+
+/// デストラクタ.
+CutContext::~CutContext()
+{
+  invalidate();
+  delete[] cutPolygonList;
+}
+
+
+/// 保持データを無効化.
+///
+///  次に使用される時に三角形ポリゴンを再収集する
+///
+void CutContext::invalidate()
+{
+  delete bvh;
+  delete store;
+  bvh = 0;
+  store = 0;
+}
+
+
+/// 保持データを直ちに再構築.
+void CutContext::refresh()
+{
+  invalidate();
+  getStore();
+}
+
+
+/// 計算対象三角形ポリゴンを得る(未構築なら構築).
+const CutTriangleStore* CutContext::getStore()
+{
+  if (store == 0) store = new CutTriangleStore(pl, &pgList);
+  return store;
+}
+
+
+/// BVHを得る(未構築なら構築).
+const CutBvh* CutContext::getBvh()
+{
+  if (bvh == 0) bvh = new CutBvh(getStore());
+  return bvh;
+}
+
+
+/// スレッド毎の交点ポリゴンリストを得る.
+///
+///  各リストはクリアのみ行い，前回の呼び出しで確保したチャンクを再利用する
+///
+///  @param[in] n スレッド数
+///  @return 空の交点ポリゴンリストn個の配列
+///
+CutPolygonList* CutContext::getPolygonList(int n)
+{
+  if (n != nThread) {
+    delete[] cutPolygonList;
+    cutPolygonList = new CutPolygonList[n];
+    nThread = n;
+  }
+  for (int i = 0; i < nThread; i++) cutPolygonList[i].clear();
+  return cutPolygonList;
+}
+
+} // namespace cutlib
@@ -0,0 +1,252 @@
+/*
+###################################################################################
+#
+# Cutlib - Cut Information Library
+#
+# Copyright (c) 2010-2011 VCAD System Research Program, RIKEN.
+# All rights reserved.
+#
+# Copyright (c) 2012-2015 Advanced Institute for Computational Science, RIKEN.
+# All rights reserved.
+#
+# Copyright (c) 2016-2017 Research Institute for Information Technology (RIIT), Kyushu University.
+# All rights reserved.
+#
+###################################################################################
+*/
+
+/// @file
+/// @brief 直交格子座標テーブルクラス
+///
+
+#ifndef CUTLIB_GRID_LATTICE_H
+#define CUTLIB_GRID_LATTICE_H
+
+#include <vector>
+#include <algorithm>   // for lower_bound, upper_bound, min_element, max_element
+#include <typeinfo>
+#include <cfloat>
+
+#include "GridAccessor/GridAccessor.h"
+#include "GridAccessor/Cell.h"
+#include "GridAccessor/Node.h"
+
+#include "Polylib.h"
+using namespace PolylibNS;
+
+namespace cutlib {
+
+/// 直交格子座標テーブルクラス.
+///
+///  計算対象領域の計算基準点座標,計算基準線分長,探索領域を
+///  方向毎の1次元テーブルとして保持する.
+///
+///  @note 方向毎のテーブルが有効なのは,GridAccessorの計算基準点座標,
+///        計算基準線分長がx方向がiのみ,y方向がjのみ,z方向がkのみに依存し，
+///        インデクスに対して単調増加である場合(直交格子)のみ.
+///        Cell,Node以外のGridAccessorでは構築時に全セルを照合し，
+///        直交格子でなければisSeparable()がfalseを返す
+///
+class CutGridLattice {
+
+  enum { X, Y, Z };
+
+  int ista[3];      ///< 計算基準点開始位置3次元インデクス
+  size_t nlen[3];   ///< 計算基準点3次元サイズ
+
+  std::vector<double> center[3];  ///< 計算基準点座標
+  std::vector<double> rangeM[3];  ///< 負方向の計算基準線分長
+  std::vector<double> rangeP[3];  ///< 正方向の計算基準線分長
+  std::vector<double> boxMin[3];  ///< 探索領域最小値(Vec3rに丸めた値)
+  std::vector<double> boxMax[3];  ///< 探索領域最大値(Vec3rに丸めた値)
+
+  bool separable;          ///< 直交格子か
+  double domainMin[3];     ///< 全セルの探索領域最小値(直交格子でない時)
+  double domainMax[3];     ///< 全セルの探索領域最大値(直交格子でない時)
+
+public:
+
+  /// コンストラクタ.
+  ///
+  ///  @param[in] ista 計算基準点開始位置3次元インデクス
+  ///  @param[in] nlen 計算基準点3次元サイズ
+  ///  @param[in] grid GridAccessorクラスオブジェクト
+  ///
+  ///  @note 探索領域はCutSearch::searchと同じくVec3rで評価する
+  ///
+  CutGridLattice(const int ista[], const size_t nlen[],
+                 const GridAccessor* grid) {
+    for (int a = 0; a < 3; a++) {
+      this->ista[a] = ista[a];
+      this->nlen[a] = nlen[a];
+    }
+    for (int a = 0; a < 3; a++) {
+      center[a].resize(nlen[a]);
+      rangeM[a].resize(nlen[a]);
+      rangeP[a].resize(nlen[a]);
+      boxMin[a].resize(nlen[a]);
+      boxMax[a].resize(nlen[a]);
+      for (size_t l = 0; l < nlen[a]; l++) {
+        int ijk[3] = { ista[X], ista[Y], ista[Z] };
+        ijk[a] += l;
+        double c[3], r[6];
+        grid->getSearchRange(ijk[X], ijk[Y], ijk[Z], c, r);
+        Vec3r min(c[X]-r[X_M], c[Y]-r[Y_M], c[Z]-r[Z_M]);
+        Vec3r max(c[X]+r[X_P], c[Y]+r[Y_P], c[Z]+r[Z_P]);
+        center[a][l] = c[a];
+        rangeM[a][l] = r[2*a];
+        rangeP[a][l] = r[2*a+1];
+        boxMin[a][l] = min[a];
+        boxMax[a][l] = max[a];
+      }
+    }
+    if (typeid(*grid) == typeid(Cell) || typeid(*grid) == typeid(Node)) {
+      separable = true;
+    } else {
+      separable = checkSeparable(grid);
+    }
+  }
+
+  /// デストラクタ.
+  ~CutGridLattice() {}
+
+  /// a方向の開始位置を得る.
+  int getStart(int a) const { return ista[a]; }
+
+  /// a方向のサイズを得る.
+  size_t getSize(int a) const { return nlen[a]; }
+
+  /// a方向の計算基準点座標を得る(lは開始位置からの相対インデクス).
+  double getCenter(int a, size_t l) const { return center[a][l]; }
+
+  /// a方向の負方向計算基準線分長を得る.
+  double getRangeM(int a, size_t l) const { return rangeM[a][l]; }
+
+  /// a方向の正方向計算基準線分長を得る.
+  double getRangeP(int a, size_t l) const { return rangeP[a][l]; }
+
+  /// a方向の探索領域最小値を得る.
+  double getBoxMin(int a, size_t l) const { return boxMin[a][l]; }
+
+  /// a方向の探索領域最大値を得る.
+  double getBoxMax(int a, size_t l) const { return boxMax[a][l]; }
+
+  /// 直交格子か(方向毎のテーブルが全セルで有効か)を得る.
+  bool isSeparable() const { return separable; }
+
+  /// 計算対象領域全体の探索領域を得る.
+  ///
+  ///  @param[out] min,max 探索領域
+  ///  @return true:成功/false:計算対象領域が空
+  ///
+  bool getDomain(Vec3r& min, Vec3r& max) const {
+    for (int a = 0; a < 3; a++) {
+      if (nlen[a] == 0) return false;
+      if (!separable) {
+        min[a] = domainMin[a];
+        max[a] = domainMax[a];
+        continue;
+      }
+      min[a] = *std::min_element(boxMin[a].begin(), boxMin[a].end());
+      max[a] = *std::max_element(boxMax[a].begin(), boxMax[a].end());
+    }
+    return true;
+  }
+
+  /// 計算基準点座標がp以上となる最初のa方向相対インデクスを得る.
+  long lowerBoundCenter(int a, double p) const {
+    return std::lower_bound(center[a].begin(), center[a].end(), p)
+         - center[a].begin();
+  }
+
+  /// 計算基準点座標がpを越える最初のa方向相対インデクスを得る.
+  long upperBoundCenter(int a, double p) const {
+    return std::upper_bound(center[a].begin(), center[a].end(), p)
+         - center[a].begin();
+  }
+
+  /// 探索領域が区間[min,max]と交わるa方向の範囲を得る.
+  ///
+  ///  @param[in] a 方向(X,Y,Z)
+  ///  @param[in] min,max 区間
+  ///  @param[out] l0,l1 相対インデクス範囲(l0 > l1の時は交わる範囲なし)
+  ///
+  void findRange(int a, double min, double max, long& l0, long& l1) const {
+    l0 = std::lower_bound(boxMax[a].begin(), boxMax[a].end(), min)
+       - boxMax[a].begin();
+    l1 = std::upper_bound(boxMin[a].begin(), boxMin[a].end(), max)
+       - boxMin[a].begin() - 1;
+  }
+
+private:
+
+  /// 全セルの探索領域を方向毎のテーブルと照合する.
+  ///
+  ///  同時に全セルの探索領域を包含する領域をdomainMin,domainMaxに求める.
+  ///
+  ///  @param[in] grid GridAccessorクラスオブジェクト
+  ///  @return true:直交格子/false:直交格子でない
+  ///
+  bool checkSeparable(const GridAccessor* grid) {
+    for (int a = 0; a < 3; a++) {
+      domainMin[a] = DBL_MAX;
+      domainMax[a] = -DBL_MAX;
+    }
+    long nij = (long)nlen[X] * (long)nlen[Y];
+    long n = nij * (long)nlen[Z];
+    long nBad = 0;
+
+#pragma omp parallel
+    {
+      double tMin[3] = { DBL_MAX, DBL_MAX, DBL_MAX };
+      double tMax[3] = { -DBL_MAX, -DBL_MAX, -DBL_MAX };
+
+#pragma omp for reduction(+:nBad) schedule(static)
+      for (long l = 0; l < n; l++) {
+        size_t u = (size_t)l;
+        size_t lc[3] = { u % nlen[X], (u / nlen[X]) % nlen[Y],
+                         u / (size_t)nij };
+        double c[3], r[6];
+        grid->getSearchRange(ista[X]+(int)lc[X], ista[Y]+(int)lc[Y],
+                             ista[Z]+(int)lc[Z], c, r);
+        Vec3r min(c[X]-r[X_M], c[Y]-r[Y_M], c[Z]-r[Z_M]);
+        Vec3r max(c[X]+r[X_P], c[Y]+r[Y_P], c[Z]+r[Z_P]);
+        bool match = true;
+        for (int a = 0; a < 3; a++) {
+          if (c[a] != center[a][lc[a]] || r[2*a] != rangeM[a][lc[a]]
+                                       || r[2*a+1] != rangeP[a][lc[a]]) {
+            match = false;
+          }
+          tMin[a] = std::min(tMin[a], (double)min[a]);
+          tMax[a] = std::max(tMax[a], (double)max[a]);
+        }
+        if (!match) nBad++;
+      }
+
+#pragma omp critical
+      {
+        for (int a = 0; a < 3; a++) {
+          domainMin[a] = std::min(domainMin[a], tMin[a]);
+          domainMax[a] = std::max(domainMax[a], tMax[a]);
+        }
+      }
+    }
+    if (nBad > 0) return false;
+
+    // 二分探索のため各テーブルは単調増加であること
+    for (int a = 0; a < 3; a++) {
+      for (size_t l = 1; l < nlen[a]; l++) {
+        if (center[a][l] < center[a][l-1] || boxMin[a][l] < boxMin[a][l-1]
+                                          || boxMax[a][l] < boxMax[a][l-1]) {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+
+};
+
+} // namespace cutlib
+
+#endif // CUTLIB_GRID_LATTICE_H
@@ -0,0 +1,103 @@
+/*
+###################################################################################
+#
+# Cutlib - Cut Information Library
+#
+# Copyright (c) 2010-2011 VCAD System Research Program, RIKEN.
+# All rights reserved.
+#
+# Copyright (c) 2012-2015 Advanced Institute for Computational Science, RIKEN.
+# All rights reserved.
+#
+# Copyright (c) 2016-2017 Research Institute for Information Technology (RIIT), Kyushu University.
+# All rights reserved.
+#
+###################################################################################
+*/
+
+
+/// @file
+/// @brief 三角形ポリゴン占有ブリッククラス 実装
+///
+
+#include "CutOccupancy.h"
+
+#include <algorithm>   // for min, max, lower_bound, upper_bound
+#ifdef CUTLIB_DEBUG
+#include <iostream>
+#endif
+
+namespace cutlib {
+
+/// コンストラクタ.
+///
+///  @param[in] lattice 計算対象領域の直交格子座標テーブル
+///  @param[in] store 計算対象三角形ポリゴン
+///  @param[in] brickSize ブリック一辺のセル数
+///
+CutOccupancy::CutOccupancy(const CutGridLattice* lattice,
+                           const CutTriangleStore* store, int brickSize)
+  : brickSize(brickSize)
+{
+  // 各方向のブリック探索領域(ブリック内セルの探索領域の和)
+  std::vector<double> brickMin[3];
+  std::vector<double> brickMax[3];
+  for (int a = 0; a < 3; a++) {
+    ista[a] = lattice->getStart(a);
+    nlen[a] = lattice->getSize(a);
+    nBrick[a] = (lattice->getSize(a) + brickSize - 1) / brickSize;
+    brickMin[a].resize(nBrick[a]);
+    brickMax[a].resize(nBrick[a]);
+    for (size_t l = 0; l < lattice->getSize(a); l++) {
+      size_t b = l / brickSize;
+      if (l % brickSize == 0) {
+        brickMin[a][b] = lattice->getBoxMin(a, l);
+        brickMax[a][b] = lattice->getBoxMax(a, l);
+      } else {
+        brickMin[a][b] = std::min(brickMin[a][b], lattice->getBoxMin(a, l));
+        brickMax[a][b] = std::max(brickMax[a][b], lattice->getBoxMax(a, l));
+      }
+    }
+  }
+
+  count.assign(nBrick[X] * nBrick[Y] * nBrick[Z], 0);
+  if (count.empty()) return;
+
+  int nTriangle = (int)store->getNumTriangle();
+  for (int t = 0; t < nTriangle; t++) {
+    long r[6];
+    for (int a = 0; a < 3; a++) {
+      double min = store->getBBoxMin(t)[a];
+      double max = store->getBBoxMax(t)[a];
+      r[2*a] = std::lower_bound(brickMax[a].begin(), brickMax[a].end(), min)
+             - brickMax[a].begin();
+      r[2*a+1] = std::upper_bound(brickMin[a].begin(), brickMin[a].end(), max)
+               - brickMin[a].begin() - 1;
+    }
+    for (long bk = r[4]; bk <= r[5]; bk++) {
+      for (long bj = r[2]; bj <= r[3]; bj++) {
+        for (long bi = r[0]; bi <= r[1]; bi++) {
+          count[bi + bj*nBrick[X] + bk*nBrick[X]*nBrick[Y]]++;
+        }
+      }
+    }
+  }
+
+#ifdef CUTLIB_DEBUG
+  std::cout << "CutOccupancy: " << getNumOccupied() << " / "
+            << count.size() << " bricks occupied" << std::endl;
+#endif
+}
+
+
+/// 占有されているブリック数を得る.
+size_t CutOccupancy::getNumOccupied() const
+{
+  size_t n = 0;
+  for (size_t b = 0; b < count.size(); b++) {
+    if (count[b] > 0) n++;
+  }
+  return n;
+}
+
+} // namespace cutlib
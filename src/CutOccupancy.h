@@ -0,0 +1,130 @@
+/*
+###################################################################################
+#
+# Cutlib - Cut Information Library
+#
+# Copyright (c) 2010-2011 VCAD System Research Program, RIKEN.
+# All rights reserved.
+#
+# Copyright (c) 2012-2015 Advanced Institute for Computational Science, RIKEN.
+# All rights reserved.
+#
+# Copyright (c) 2016-2017 Research Institute for Information Technology (RIIT), Kyushu University.
+# All rights reserved.
+#
+###################################################################################
+*/
+
+
+/// @file
+/// @brief 三角形ポリゴン占有ブリッククラス 宣言
+///
+
+#ifndef CUTLIB_OCCUPANCY_H
+#define CUTLIB_OCCUPANCY_H
+
+#include <vector>
+#include <algorithm>   // for min
+
+#include "CutGridLattice.h"
+#include "CutTriangleStore.h"
+
+namespace cutlib {
+
+/// 三角形ポリゴン占有ブリッククラス.
+///
+///  計算対象領域をbrickSize^3セルのブリックに分割し，ブリック内の
+///  セルの探索領域とBBoxが交わる三角形ポリゴンの数を保持する.
+///  探索領域は計算基準点から計算基準線分長(セル幅)だけ広がっているため，
+///  三角形ポリゴンのBBoxをセル幅分膨らませて判定するのと同じになる.
+///  占有されていないブリックのセルは交点を持たないので，
+///  セル毎の探索を省略できる(交点情報はclear()済みの値のまま).
+///
+///  @note 直交格子を仮定(CutGridLattice参照).
+///        CutGridLattice::isSeparable()がfalseの時は使用しない
+///
+class CutOccupancy {
+
+  enum { X, Y, Z };
+
+  int ista[3];       ///< 計算基準点開始位置3次元インデクス
+  size_t nlen[3];    ///< 計算基準点3次元サイズ
+  int brickSize;     ///< ブリック一辺のセル数
+  size_t nBrick[3];  ///< 各方向のブリック数
+
+  std::vector<int> count;  ///< ブリック毎の三角形ポリゴン数
+
+public:
+
+  /// デフォルトのブリック一辺のセル数.
+  static const int DefaultBrickSize = 8;
+
+  /// コンストラクタ.
+  ///
+  ///  @param[in] lattice 計算対象領域の直交格子座標テーブル
+  ///  @param[in] store 計算対象三角形ポリゴン
+  ///  @param[in] brickSize ブリック一辺のセル数
+  ///
+  CutOccupancy(const CutGridLattice* lattice, const CutTriangleStore* store,
+               int brickSize = DefaultBrickSize);
+
+  /// デストラクタ.
+  ~CutOccupancy() {}
+
+  /// セル(i,j,k)を含むブリックの一次元ブリック番号を得る.
+  size_t getBrick(int i, int j, int k) const {
+    return ((i - ista[X]) / brickSize)
+         + ((j - ista[Y]) / brickSize) * nBrick[X]
+         + ((k - ista[Z]) / brickSize) * nBrick[X] * nBrick[Y];
+  }
+
+  /// セル(i,j,k)を含むブリックが占有されているか.
+  bool isOccupied(int i, int j, int k) const {
+    return count[getBrick(i, j, k)] > 0;
+  }
+
+  /// ブリックbが占有されているか.
+  bool isOccupied(size_t b) const { return count[b] > 0; }
+
+  /// ブリックbの探索領域とBBoxが交わる三角形ポリゴン数を得る.
+  int getCount(size_t b) const { return count[b]; }
+
+  /// ブリック総数を得る.
+  size_t getNumBrick() const { return count.size(); }
+
+  /// a方向のブリック数を得る.
+  size_t getNumBrick(int a) const { return nBrick[a]; }
+
+  /// ブリック座標(bi,bj,bk)の一次元ブリック番号を得る.
+  size_t getBrickIndex(size_t bi, size_t bj, size_t bk) const {
+    return bi + bj * nBrick[X] + bk * nBrick[X] * nBrick[Y];
+  }
+
+  /// ブリックbに含まれるセルの範囲を得る.
+  ///
+  ///  @param[in] b 一次元ブリック番号
+  ///  @param[out] s 開始位置3次元インデクス
+  ///  @param[out] e 終了位置の次の3次元インデクス
+  ///
+  void getBrickRange(size_t b, int s[], int e[]) const {
+    size_t bi[3];
+    bi[X] = b % nBrick[X];
+    bi[Y] = (b / nBrick[X]) % nBrick[Y];
+    bi[Z] = b / (nBrick[X] * nBrick[Y]);
+    for (int a = 0; a < 3; a++) {
+      s[a] = ista[a] + bi[a] * brickSize;
+      e[a] = std::min(s[a] + brickSize, ista[a] + (int)nlen[a]);
+    }
+  }
+
+  /// ブリック一辺のセル数を得る.
+  int getBrickSize() const { return brickSize; }
+
+  /// 占有されているブリック数を得る.
+  size_t getNumOccupied() const;
+
+};
+
+} // namespace cutlib
+
+#endif // CUTLIB_OCCUPANCY_H
@@ -22,15 +22,37 @@
 #include "CutOctree.h"
 #include "CutSearch.h"
 
-#ifdef CUTLIB_TIMING
-#include "CutTiming.h"
-#endif
-
-#include <algorithm>   // for min, max
+#include <algorithm>   // for min, max, sort
 
 namespace cutlib {
 namespace cutOctree {
 
+namespace {
+
+/// BBoxが検索領域と交わる三角形番号を収集する関数オブジェクト.
+class TriangleIdCollector {
+
+  const CutTriangleStore* store;  ///< 計算対象三角形ポリゴン
+  const Vec3r& min;               ///< 検索領域最小値
+  const Vec3r& max;               ///< 検索領域最大値
+
+public:
+
+  std::vector<int> ids;  ///< 三角形番号リスト
+
+  TriangleIdCollector(const CutTriangleStore* store,
+                      const Vec3r& min, const Vec3r& max)
+    : store(store), min(min), max(max) {}
+
+  void operator()(int t) {
+    if (store->overlap(t, min, max)) ids.push_back(t);
+  }
+
+};
+
+} // namespace ANONYMOUS
+
+
 /// コンストラクタ.
 ///
 ///  @param[in] t Polylib三角形ポリゴンクラス
@@ -61,40 +83,26 @@ bool CutTriangle::intersectBox(const Vec3r& min, const Vec3r& max)
 }
 
 
-/// Polylib検索メソッドの結果をカスタムリストに追加.
+/// BVH検索の結果をカスタムリストに追加.
+///
+///  三角形は計算対象三角形ポリゴンの格納順に追加する
 ///
 ///  @param[in,out] ctList 三角形リスト
-///  @param[in] pl Polylibクラスオブジェクト
-///  @param[in] pgList ポリゴングループ(パス名)リスト
+///  @param[in] bvh 三角形ポリゴンBVH
 ///  @param[in] min,max 検索領域
 ///
-void CutTriangle::AppendCutTriangles(CutTriangles& ctList,
-                                     const Polylib* pl,
-                                     const std::vector<std::string>* pgList,
+void CutTriangle::AppendCutTriangles(CutTriangles& ctList, const CutBvh* bvh,
                                      const Vec3r& min, const Vec3r& max)
 {
-  std::vector<std::string>::const_iterator pg;
-  for (pg = pgList->begin(); pg != pgList->end(); ++pg) {
-
-#ifdef CUTLIB_TIMING
-    Timer::Start(SEARCH_POLYGON);
-#endif
-
-    std::vector<Triangle*>* tList = pl->search_polygons(*pg, min, max, false);
-
-#ifdef CUTLIB_TIMING
-    Timer::Stop(SEARCH_POLYGON);
-#endif
-
-    std::vector<Triangle*>::const_iterator t;
-    for (t = tList->begin(); t != tList->end(); ++t) {
-      int exid = (*t)->get_exid();
-      if (0 < exid && exid < 256) {
-        CutTriangle* ct = new CutTriangle(*t);
-        ctList.push_back(ct);
-      }
-    }
-  delete tList;
+  const CutTriangleStore* store = bvh->getStore();
+  TriangleIdCollector f(store, min, max);
+  bvh->query(min, max, f);
+  std::sort(f.ids.begin(), f.ids.end());
+
+  std::vector<int>::const_iterator t;
+  for (t = f.ids.begin(); t != f.ids.end(); ++t) {
+    CutTriangle* ct = new CutTriangle(store->getTriangle(*t));
+    ctList.push_back(ct);
   }
 }
 
@@ -61,16 +61,15 @@ public:
   ///
   bool intersectBox(const Vec3r& min, const Vec3r& max);
 
-  /// Polylib検索メソッドの結果をカスタムリストに追加.
+  /// BVH検索の結果をカスタムリストに追加.
+  ///
+  ///  三角形は計算対象三角形ポリゴンの格納順に追加する
   ///
   ///  @param[in,out] ctList 三角形リスト
-  ///  @param[in] pl Polylibクラスオブジェクト
-  ///  @param[in] pgList ポリゴングループ(パス名)リスト
+  ///  @param[in] bvh 三角形ポリゴンBVH
   ///  @param[in] min,max 検索領域
   ///
-  static void AppendCutTriangles(CutTriangles& ctList,
-                                 const Polylib* pl,
-                                 const std::vector<std::string>* pgList,
+  static void AppendCutTriangles(CutTriangles& ctList, const CutBvh* bvh,
                                  const Vec3r& min, const Vec3r& max);
 
   /// 直方体領域と交わる三角形のリストをコピー.
@@ -0,0 +1,215 @@
+/*
+###################################################################################
+#
+# Cutlib - Cut Information Library
+#
+# Copyright (c) 2010-2011 VCAD System Research Program, RIKEN.
+# All rights reserved.
+#
+# Copyright (c) 2012-2015 Advanced Institute for Computational Science, RIKEN.
+# All rights reserved.
+#
+# Copyright (c) 2016-2017 Research Institute for Information Technology (RIIT), Kyushu University.
+# All rights reserved.
+#
+###################################################################################
+*/
+
+/// @file
+/// @brief 格子線単位交点計算クラス 実装
+///
+
+#include "CutScanline.h"
+
+#include <algorithm>   // for sort
+
+#ifdef _OPENMP
+#include "omp.h"
+#endif
+
+namespace cutlib {
+
+/// a方向の格子線について交点情報を計算.
+///
+///  a方向の2方向(負,正)の交点座標,境界IDのみを設定する
+///
+///  @param[in] a 格子線の方向(X,Y,Z)
+///  @param[in,out] cutPos 交点座標配列ラッパ
+///  @param[in,out] cutBid 境界ID配列ラッパ
+///  @param[in] cutNormal 法線ベクトル格納クラス(0の時は交点ポリゴンを収集しない)
+///  @param[in,out] cutPolygonList スレッド毎の交点ポリゴンリスト
+///
+///  @note cutPos,cutBidはクリア済みであること
+///
+void CutScanline::search(int a, CutPosArray* cutPos, CutBidArray* cutBid,
+                         const CutNormalArray* cutNormal,
+                         CutPolygonList* cutPolygonList) const
+{
+  const CutGridLattice& lattice = *index->getLattice();
+  const CutTriangleStore* store = index->getStore();
+  int b = (a + 1) % 3;
+  int c = (a + 2) % 3;
+  long na = lattice.getSize(a);
+  long nb = lattice.getSize(b);
+  long nc = lattice.getSize(c);
+  int dM = 2 * a;
+  int dP = 2 * a + 1;
+
+#pragma omp parallel
+  {
+  int iThread;
+#ifdef _OPENMP
+  iThread = omp_get_thread_num();
+#else
+  iThread = 0;
+#endif
+  std::vector<int> stamp(store->getNumTriangle(), -1);
+  std::vector<Hit> hits;
+  std::vector<int> cand;
+  std::vector<double> candP;
+  int stampId = 0;
+
+#pragma omp for schedule(dynamic), collapse(2)
+  for (long lc = 0; lc < nc; lc++) {
+    for (long lb = 0; lb < nb; lb++) {
+      collectHits(a, lb, lc, stamp, stampId++, cand, candP, hits);
+      size_t nHit = hits.size();
+      if (nHit == 0) continue;
+
+      int ijk[3];
+      ijk[b] = lattice.getStart(b) + lb;
+      ijk[c] = lattice.getStart(c) + lc;
+
+      size_t h0 = 0;  // 計算基準点以上の最初の交点
+      size_t h1 = 0;  // 計算基準点を越える最初の交点
+      for (long la = 0; la < na; la++) {
+        double center = lattice.getCenter(a, la);
+        double aMin = lattice.getBoxMin(a, la);
+        double aMax = lattice.getBoxMax(a, la);
+        while (h0 < nHit && hits[h0].p < center) h0++;
+        while (h1 < nHit && hits[h1].p <= center) h1++;
+
+        // 正方向: 同じ距離では三角形番号の小さい方を採用
+        double rangeP = lattice.getRangeP(a, la);
+        double posP = rangeP;
+        int tP = -1;
+        for (size_t h = h0; h < nHit; h++) {
+          double pos = hits[h].p - center;
+          if (pos > posP) break;
+          if (!store->overlap(hits[h].t, a, aMin, aMax)) continue;
+          if (pos < posP || (tP >= 0 && hits[h].t < tP)) {
+            posP = pos;
+            tP = hits[h].t;
+          }
+        }
+
+        // 負方向
+        double rangeM = lattice.getRangeM(a, la);
+        double posM = rangeM;
+        int tM = -1;
+        for (size_t h = h1; h-- > 0; ) {
+          double pos = center - hits[h].p;
+          if (pos > posM) break;
+          if (!store->overlap(hits[h].t, a, aMin, aMax)) continue;
+          if (pos < posM || (tM >= 0 && hits[h].t < tM)) {
+            posM = pos;
+            tM = hits[h].t;
+          }
+        }
+
+        ijk[a] = lattice.getStart(a) + la;
+        if (tM >= 0) {
+          cutPos->setPos(ijk[X], ijk[Y], ijk[Z], dM, (float)(posM/rangeM));
+          cutBid->setBid(ijk[X], ijk[Y], ijk[Z], dM, store->getBid(tM));
+          if (cutNormal) {
+            cutPolygonList[iThread].push_back(
+              CutPolygon(cutNormal->getIndex(ijk[X], ijk[Y], ijk[Z]),
+                         dM, store->getTriangle(tM)));
+          }
+        }
+        if (tP >= 0) {
+          cutPos->setPos(ijk[X], ijk[Y], ijk[Z], dP, (float)(posP/rangeP));
+          cutBid->setBid(ijk[X], ijk[Y], ijk[Z], dP, store->getBid(tP));
+          if (cutNormal) {
+            cutPolygonList[iThread].push_back(
+              CutPolygon(cutNormal->getIndex(ijk[X], ijk[Y], ijk[Z]),
+                         dP, store->getTriangle(tP)));
+          }
+        }
+      }
+    }
+  }
+  } // parallel region
+}
+
+
+/// 格子線と三角形ポリゴンの交点を収集し，ソート.
+///
+///  格子線が通過するブリックの三角形ポリゴンを重複なく集め，
+///  交点を一括計算する
+///
+///  @param[in] a 格子線の方向(X,Y,Z)
+///  @param[in] lb,lc 格子線位置(開始位置からの相対インデクス)
+///  @param[in,out] stamp 三角形毎の調査済み格子線番号
+///  @param[in] stampId 格子線番号
+///  @param[out] cand 作業領域(調査対象三角形番号)
+///  @param[out] candP 作業領域(交点座標)
+///  @param[out] hits 交点列
+///
+void CutScanline::collectHits(int a, size_t lb, size_t lc,
+                              std::vector<int>& stamp, int stampId,
+                              std::vector<int>& cand,
+                              std::vector<double>& candP,
+                              std::vector<Hit>& hits) const
+{
+  const CutGridLattice& lattice = *index->getLattice();
+  const CutTriangleStore* store = index->getStore();
+  const CutTriangleCache* cache = store->getCache();
+  int b = (a + 1) % 3;
+  int c = (a + 2) % 3;
+
+  double posB = lattice.getCenter(b, lb);
+  double posC = lattice.getCenter(c, lc);
+  double bMin = lattice.getBoxMin(b, lb);
+  double bMax = lattice.getBoxMax(b, lb);
+  double cMin = lattice.getBoxMin(c, lc);
+  double cMax = lattice.getBoxMax(c, lc);
+
+  int ijk[3];
+  ijk[b] = lattice.getStart(b) + lb;
+  ijk[c] = lattice.getStart(c) + lc;
+
+  cand.clear();
+  for (size_t la = 0; la < lattice.getSize(a); la += index->getBinSize()) {
+    ijk[a] = lattice.getStart(a) + la;
+    const int* t;
+    const int* tEnd;
+    index->getBin(ijk[X], ijk[Y], ijk[Z], t, tEnd);
+    for (; t != tEnd; ++t) {
+      if (stamp[*t] == stampId) continue;
+      stamp[*t] = stampId;
+      if (!store->overlap(*t, b, bMin, bMax)) continue;
+      if (!store->overlap(*t, c, cMin, cMax)) continue;
+      cand.push_back(*t);
+    }
+  }
+
+  hits.clear();
+  if (cand.empty()) return;
+  candP.resize(cand.size());
+  cache->intersect(a, posB, posC, cand.size(), &cand[0], &candP[0]);
+
+  // 交点なし,縮退三角形による交点座標NaNは除外(セル毎の探索でも採用されない)
+  for (size_t n = 0; n < cand.size(); n++) {
+    if (candP[n] == candP[n]) {
+      Hit hit;
+      hit.p = candP[n];
+      hit.t = cand[n];
+      hits.push_back(hit);
+    }
+  }
+
+  std::sort(hits.begin(), hits.end());
+}
+
+} // namespace cutlib
@@ -0,0 +1,103 @@
+/*
+###################################################################################
+#
+# Cutlib - Cut Information Library
+#
+# Copyright (c) 2010-2011 VCAD System Research Program, RIKEN.
+# All rights reserved.
+#
+# Copyright (c) 2012-2015 Advanced Institute for Computational Science, RIKEN.
+# All rights reserved.
+#
+# Copyright (c) 2016-2017 Research Institute for Information Technology (RIIT), Kyushu University.
+# All rights reserved.
+#
+###################################################################################
+*/
+
+/// @file
+/// @brief 格子線単位交点計算クラス 宣言
+///
+
+#ifndef CUTLIB_SCANLINE_H
+#define CUTLIB_SCANLINE_H
+
+#include <vector>
+
+#include "Cutlib.h"
+#include "CutBinIndex.h"
+
+namespace cutlib {
+
+/// 格子線単位交点計算クラス.
+///
+///  座標軸に平行な格子線毎に三角形ポリゴンとの交点を一度だけ計算し，
+///  線上でソートした交点列を掃引して各セルの交点情報を設定する.
+///  結果はCutSearch::searchをセル毎に呼び出した場合と一致する.
+///
+class CutScanline {
+
+  enum { X, Y, Z };
+
+  /// 格子線上の交点.
+  struct Hit {
+    double p;  ///< 交点座標
+    int t;     ///< 三角形番号
+
+    /// 交点座標,三角形番号の順で比較.
+    bool operator<(const Hit& h) const {
+      return p < h.p || (p == h.p && t < h.t);
+    }
+  };
+
+  const CutBinIndex* index;  ///< 三角形ポリゴン空間インデクス
+
+public:
+
+  /// コンストラクタ.
+  ///
+  ///  @param[in] index 三角形ポリゴン空間インデクス
+  ///
+  CutScanline(const CutBinIndex* index) : index(index) {}
+
+  /// デストラクタ.
+  ~CutScanline() {}
+
+  /// a方向の格子線について交点情報を計算.
+  ///
+  ///  a方向の2方向(負,正)の交点座標,境界IDのみを設定する
+  ///
+  ///  @param[in] a 格子線の方向(X,Y,Z)
+  ///  @param[in,out] cutPos 交点座標配列ラッパ
+  ///  @param[in,out] cutBid 境界ID配列ラッパ
+  ///  @param[in] cutNormal 法線ベクトル格納クラス(0の時は交点ポリゴンを収集しない)
+  ///  @param[in,out] cutPolygonList スレッド毎の交点ポリゴンリスト
+  ///
+  ///  @note cutPos,cutBidはクリア済みであること
+  ///
+  void search(int a, CutPosArray* cutPos, CutBidArray* cutBid,
+              const CutNormalArray* cutNormal,
+              CutPolygonList* cutPolygonList) const;
+
+private:
+
+  /// 格子線と三角形ポリゴンの交点を収集し，ソート.
+  ///
+  ///  @param[in] a 格子線の方向(X,Y,Z)
+  ///  @param[in] lb,lc 格子線位置(開始位置からの相対インデクス)
+  ///  @param[in,out] stamp 三角形毎の調査済み格子線番号
+  ///  @param[in] stampId 格子線番号
+  ///  @param[out] cand 作業領域(調査対象三角形番号)
+  ///  @param[out] candP 作業領域(交点座標)
+  ///  @param[out] hits 交点列
+  ///
+  void collectHits(int a, size_t lb, size_t lc,
+                   std::vector<int>& stamp, int stampId,
+                   std::vector<int>& cand, std::vector<double>& candP,
+                   std::vector<Hit>& hits) const;
+
+};
+
+} // namespace cutlib
+
+#endif // CUTLIB_SCANLINE_H
@@ -0,0 +1,209 @@
+/*
+###################################################################################
+#
+# Cutlib - Cut Information Library
+#
+# Copyright (c) 2010-2011 VCAD System Research Program, RIKEN.
+# All rights reserved.
+#
+# Copyright (c) 2012-2015 Advanced Institute for Computational Science, RIKEN.
+# All rights reserved.
+#
+# Copyright (c) 2016-2017 Research Institute for Information Technology (RIIT), Kyushu University.
+# All rights reserved.
+#
+###################################################################################
+*/
+
+/// @file
+/// @brief 三角形単位交点計算クラス 実装
+///
+
+#include "CutScatter.h"
+
+#include <algorithm>   // for sort, min, max
+
+#ifdef _OPENMP
+#include "omp.h"
+#endif
+
+namespace cutlib {
+
+/// 全三角形ポリゴンについて交点情報を計算.
+///
+///  三角形ポリゴン毎の交点候補をスレッド毎・バケット毎に収集し，
+///  バケット毎に並列にソートして，セル・方向毎の最近接候補を設定する
+///
+///  @param[in,out] cutPos 交点座標配列ラッパ
+///  @param[in,out] cutBid 境界ID配列ラッパ
+///  @param[in] cutNormal 法線ベクトル格納クラス(0の時は交点ポリゴンを収集しない)
+///  @param[in,out] cutPolygonList スレッド毎の交点ポリゴンリスト
+///
+///  @note cutPos,cutBidはクリア済みであること
+///
+void CutScatter::search(CutPosArray* cutPos, CutBidArray* cutBid,
+                        const CutNormalArray* cutNormal,
+                        CutPolygonList* cutPolygonList) const
+{
+  const CutGridLattice& lattice = *this->lattice;
+  int nTri = store->getNumTriangle();
+
+  int nThread;
+#ifdef _OPENMP
+  nThread = omp_get_max_threads();
+#else
+  nThread = 1;
+#endif
+
+  // セル番号範囲によるバケット分割
+  size_t nCell = lattice.getSize(X) * lattice.getSize(Y) * lattice.getSize(Z);
+  if (nCell == 0) return;
+  int nBucket = BucketPerThread * nThread;
+  size_t bucketSize = (nCell + nBucket - 1) / nBucket;
+  if (bucketSize == 0) bucketSize = 1;
+  nBucket = (int)((nCell + bucketSize - 1) / bucketSize);
+
+  // candList[iThread*nBucket+b]: スレッドiThreadが収集したバケットbの候補
+  std::vector<std::vector<Candidate> > candList((size_t)nThread * nBucket);
+
+#pragma omp parallel
+  {
+  int iThread;
+#ifdef _OPENMP
+  iThread = omp_get_thread_num();
+#else
+  iThread = 0;
+#endif
+
+  std::vector<Candidate>* myCand = &candList[(size_t)iThread * nBucket];
+#pragma omp for schedule(dynamic)
+  for (int t = 0; t < nTri; t++) {
+    for (int a = 0; a < 3; a++) scatter(t, a, bucketSize, myCand);
+  }
+
+  // バケット毎に全スレッドの候補をまとめてソート，設定
+  //  (バケット間でセルが重ならないため，CutPos8,CutBid5でも競合しない)
+  std::vector<Candidate> cand;
+#pragma omp for schedule(dynamic)
+  for (int b = 0; b < nBucket; b++) {
+    cand.clear();
+    for (int i = 0; i < nThread; i++) {
+      std::vector<Candidate>& part = candList[(size_t)i * nBucket + b];
+      cand.insert(cand.end(), part.begin(), part.end());
+      std::vector<Candidate>().swap(part);
+    }
+    std::sort(cand.begin(), cand.end());
+    resolve(cand, cutPos, cutBid, cutNormal, cutPolygonList[iThread]);
+  }
+  } // parallel region
+}
+
+
+/// ソート済みの交点候補から，セル・方向毎の最近接候補を設定.
+///
+///  @param[in] cand 交点候補リスト(ソート済み)
+///  @param[in,out] cutPos 交点座標配列ラッパ
+///  @param[in,out] cutBid 境界ID配列ラッパ
+///  @param[in] cutNormal 法線ベクトル格納クラス(0の時は交点ポリゴンを収集しない)
+///  @param[in,out] cutPolygonList 実行スレッドの交点ポリゴンリスト
+///
+void CutScatter::resolve(const std::vector<Candidate>& cand,
+                         CutPosArray* cutPos, CutBidArray* cutBid,
+                         const CutNormalArray* cutNormal,
+                         CutPolygonList& cutPolygonList) const
+{
+  const CutGridLattice& lattice = *this->lattice;
+  size_t nx = lattice.getSize(X);
+  size_t ny = lattice.getSize(Y);
+  for (size_t n = 0; n < cand.size(); n++) {
+    const Candidate& c = cand[n];
+    if (n > 0 && c.cell == cand[n-1].cell && c.d == cand[n-1].d) continue;
+    int i = lattice.getStart(X) + c.cell % nx;
+    int j = lattice.getStart(Y) + (c.cell / nx) % ny;
+    int k = lattice.getStart(Z) + c.cell / (nx * ny);
+    size_t l = (c.d / 2 == X) ? c.cell % nx
+             : (c.d / 2 == Y) ? (c.cell / nx) % ny : c.cell / (nx * ny);
+    double range = (c.d % 2 == 0) ? lattice.getRangeM(c.d / 2, l)
+                                  : lattice.getRangeP(c.d / 2, l);
+    cutPos->setPos(i, j, k, c.d, (float)(c.pos/range));
+    cutBid->setBid(i, j, k, c.d, store->getBid(c.t));
+    if (cutNormal) {
+      cutPolygonList.push_back(CutPolygon(cutNormal->getIndex(i, j, k),
+                                          c.d, store->getTriangle(c.t)));
+    }
+  }
+}
+
+
+/// 三角形ポリゴンとa方向格子線の交点から交点候補を作成.
+///
+///  BBoxが交わる格子線毎に交点を求め，交点を計算基準線分に含むセルへ
+///  負方向,正方向の交点候補を追加する
+///
+///  @param[in] t 三角形番号
+///  @param[in] a 格子線の方向(X,Y,Z)
+///  @param[in] bucketSize バケットあたりのセル数
+///  @param[in,out] cand バケット毎の交点候補リスト
+///
+///  @note 探索領域はCutSearch::searchと同じくBBoxの交差で判定する.
+///        計算基準線分の端点が単調増加であることを利用し，交点から
+///        離れる方向へセルを調べ，線分に含まれなくなった所で打ち切る
+///
+void CutScatter::scatter(int t, int a, size_t bucketSize,
+                         std::vector<Candidate>* cand) const
+{
+  const CutGridLattice& lattice = *this->lattice;
+  int b = (a + 1) % 3;
+  int c = (a + 2) % 3;
+  const Vec3r& tMin = store->getBBoxMin(t);
+  const Vec3r& tMax = store->getBBoxMax(t);
+
+  long a0, a1, b0, b1, c0, c1;
+  lattice.findRange(a, tMin[a], tMax[a], a0, a1);
+  lattice.findRange(b, tMin[b], tMax[b], b0, b1);
+  lattice.findRange(c, tMin[c], tMax[c], c0, c1);
+  if (a0 > a1 || b0 > b1 || c0 > c1) return;
+
+  size_t nx = lattice.getSize(X);
+  size_t ny = lattice.getSize(Y);
+  size_t stride[3] = { 1, nx, nx * ny };
+  int dM = 2 * a;
+  int dP = 2 * a + 1;
+
+  const CutTriangleCache* cache = store->getCache();
+  for (long lc = c0; lc <= c1; lc++) {
+    for (long lb = b0; lb <= b1; lb++) {
+      double p;
+      if (!cache->intersect(t, a, lattice.getCenter(b, lb),
+                            lattice.getCenter(c, lc), p)) continue;
+      // 縮退三角形による交点座標NaNは除外(セル毎の探索でも採用されない)
+      if (p != p) continue;
+
+      size_t line = lb * stride[b] + lc * stride[c];
+      Candidate cd;
+      cd.t = t;
+
+      // 正方向: 計算基準点座標がp以下のセル
+      cd.d = dP;
+      for (long la = std::min(lattice.upperBoundCenter(a, p) - 1, a1);
+           la >= a0; la--) {
+        cd.pos = p - lattice.getCenter(a, la);
+        if (!(cd.pos < lattice.getRangeP(a, la))) break;
+        cd.cell = line + la * stride[a];
+        cand[cd.cell / bucketSize].push_back(cd);
+      }
+
+      // 負方向: 計算基準点座標がp以上のセル
+      cd.d = dM;
+      for (long la = std::max(lattice.lowerBoundCenter(a, p), a0);
+           la <= a1; la++) {
+        cd.pos = lattice.getCenter(a, la) - p;
+        if (!(cd.pos < lattice.getRangeM(a, la))) break;
+        cd.cell = line + la * stride[a];
+        cand[cd.cell / bucketSize].push_back(cd);
+      }
+    }
+  }
+}
+
+} // namespace cutlib
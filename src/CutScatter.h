@@ -0,0 +1,126 @@
+/*
+###################################################################################
+#
+# Cutlib - Cut Information Library
+#
+# Copyright (c) 2010-2011 VCAD System Research Program, RIKEN.
+# All rights reserved.
+#
+# Copyright (c) 2012-2015 Advanced Institute for Computational Science, RIKEN.
+# All rights reserved.
+#
+# Copyright (c) 2016-2017 Research Institute for Information Technology (RIIT), Kyushu University.
+# All rights reserved.
+#
+###################################################################################
+*/
+
+/// @file
+/// @brief 三角形単位交点計算クラス 宣言
+///
+
+#ifndef CUTLIB_SCATTER_H
+#define CUTLIB_SCATTER_H
+
+#include <vector>
+
+#include "Cutlib.h"
+#include "CutGridLattice.h"
+#include "CutTriangleStore.h"
+
+namespace cutlib {
+
+/// 三角形単位交点計算クラス.
+///
+///  三角形ポリゴン毎に，そのBBoxが覆う格子線との交点を求め，
+///  交点近傍のセルへ交点候補を振り分ける.
+///  計算量は計算領域の体積ではなく物体表面の大きさに比例するため，
+///  大きな計算領域中の小さな物体に適する.
+///  交点候補はスレッド毎に，セル番号範囲で分けたバケットへ収集する.
+///  バケット毎に全スレッドの候補をまとめてソートし，同一セル・方向への
+///  候補を交点距離,三角形番号の順で比較して一つに決定する.
+///  バケットは互いに素なセル範囲を持つため，バケット単位で並列に設定できる.
+///  結果はCutSearch::searchをセル毎に呼び出した場合と一致する.
+///
+class CutScatter {
+
+  enum { X, Y, Z };
+
+  /// セル・方向毎の交点候補.
+  struct Candidate {
+    size_t cell;  ///< セル番号(計算対象領域内の1次元インデクス)
+    int d;        ///< 方向(X_M,...,Z_P)
+    double pos;   ///< 計算基準点からの交点距離
+    int t;        ///< 三角形番号
+
+    /// セル番号,方向,交点距離,三角形番号の順で比較.
+    bool operator<(const Candidate& c) const {
+      if (cell != c.cell) return cell < c.cell;
+      if (d != c.d) return d < c.d;
+      if (pos != c.pos) return pos < c.pos;
+      return t < c.t;
+    }
+  };
+
+  /// スレッドあたりのバケット数.
+  enum { BucketPerThread = 8 };
+
+  const CutGridLattice* lattice;  ///< 直交格子座標テーブル
+  const CutTriangleStore* store;  ///< 計算対象三角形ポリゴン
+
+public:
+
+  /// コンストラクタ.
+  ///
+  ///  @param[in] lattice 計算対象領域の直交格子座標テーブル
+  ///  @param[in] store 計算対象三角形ポリゴン
+  ///
+  CutScatter(const CutGridLattice* lattice, const CutTriangleStore* store)
+    : lattice(lattice), store(store) {}
+
+  /// デストラクタ.
+  ~CutScatter() {}
+
+  /// 全三角形ポリゴンについて交点情報を計算.
+  ///
+  ///  @param[in,out] cutPos 交点座標配列ラッパ
+  ///  @param[in,out] cutBid 境界ID配列ラッパ
+  ///  @param[in] cutNormal 法線ベクトル格納クラス(0の時は交点ポリゴンを収集しない)
+  ///  @param[in,out] cutPolygonList スレッド毎の交点ポリゴンリスト
+  ///
+  ///  @note cutPos,cutBidはクリア済みであること
+  ///
+  void search(CutPosArray* cutPos, CutBidArray* cutBid,
+              const CutNormalArray* cutNormal,
+              CutPolygonList* cutPolygonList) const;
+
+private:
+
+  /// 三角形ポリゴンとa方向格子線の交点から交点候補を作成.
+  ///
+  ///  @param[in] t 三角形番号
+  ///  @param[in] a 格子線の方向(X,Y,Z)
+  ///  @param[in] bucketSize バケットあたりのセル数
+  ///  @param[in,out] cand バケット毎の交点候補リスト
+  ///
+  void scatter(int t, int a, size_t bucketSize,
+               std::vector<Candidate>* cand) const;
+
+  /// ソート済みの交点候補から，セル・方向毎の最近接候補を設定.
+  ///
+  ///  @param[in] cand 交点候補リスト(ソート済み)
+  ///  @param[in,out] cutPos 交点座標配列ラッパ
+  ///  @param[in,out] cutBid 境界ID配列ラッパ
+  ///  @param[in] cutNormal 法線ベクトル格納クラス(0の時は交点ポリゴンを収集しない)
+  ///  @param[in,out] cutPolygonList 実行スレッドの交点ポリゴンリスト
+  ///
+  void resolve(const std::vector<Candidate>& cand,
+               CutPosArray* cutPos, CutBidArray* cutBid,
+               const CutNormalArray* cutNormal,
+               CutPolygonList& cutPolygonList) const;
+
+};
+
+} // namespace cutlib
+
+#endif // CUTLIB_SCATTER_H
@@ -22,14 +22,75 @@
 #include "CutSearch.h"
 #include "TargetTriangle.h"
 
+#include <algorithm>   // for sort
+
 #ifdef CUTLIB_TIMING
 #include "CutTiming.h"
 #endif
 
 namespace cutlib {
 
+/// 探索領域と交わる三角形の収集,交点調査を行う関数オブジェクト.
+///
+///  三角形番号をBufSize個ずつまとめてCutSearch::checkTrianglesで調査する
+///
+class CutSearch::Collector {
+
+  static const int BufSize = 64;
+
+  const CutSearch* search;  ///< 交点情報計算クラス
+  const double* center;     ///< 計算基準点座標
+  double* pos6;             ///< 交点座標値配列
+  bool needSort;            ///< 三角形番号が昇順に渡されない時true
+  int buf[BufSize];         ///< 三角形番号バッファ
+  int n;                    ///< バッファ内の三角形数
+
+public:
+
+  Vec3r min;  ///< 探索領域最小値
+  Vec3r max;  ///< 探索領域最大値
+  int t6[6];  ///< 交点の三角形番号配列
+
+  Collector(const CutSearch* search, const double center[], const double range[],
+            double pos6[], bool needSort)
+    : search(search), center(center), pos6(pos6), needSort(needSort), n(0),
+      min(center[X]-range[X_M], center[Y]-range[Y_M], center[Z]-range[Z_M]),
+      max(center[X]+range[X_P], center[Y]+range[Y_P], center[Z]+range[Z_P]) {
+    for (int d = 0; d < 6; d++) t6[d] = -1;
+  }
+
+  /// 三角形のBBoxが探索領域と交われば調査対象に追加.
+  void operator()(int t) {
+    if (!search->store->overlap(t, min, max)) return;
+    buf[n++] = t;
+    if (n == BufSize) flush();
+  }
+
+  /// バッファ内の三角形を調査.
+  void flush() {
+    if (n == 0) return;
+    if (needSort) std::sort(buf, buf + n);
+    search->checkTriangles(n, buf, center, pos6, t6);
+    n = 0;
+  }
+
+  /// 交点の三角形番号から境界ID,交点ポリゴンを設定.
+  void setResult(BidType bid6[], Triangle* tri6[]) const {
+    for (int d = 0; d < 6; d++) {
+      if (t6[d] >= 0) {
+        bid6[d] = search->store->getBid(t6[d]);
+        tri6[d] = search->store->getTriangle(t6[d]);
+      }
+    }
+  }
+
+};
+
+
 /// 最近接交点の探索.
 ///
+///  BVH使用時はBVHを，それ以外はPolylibの検索メソッドを使用
+///
 ///  @param[in] center 計算基準点座標
 ///  @param[in] range  6方向毎の計算基準線分の長さ
 ///  @param[out] pos6  交点座標値配列
@@ -42,11 +103,19 @@ void CutSearch::search(const double center[], const double range[],
                        double pos6[], BidType bid6[],
                        Triangle* tri6[]) const
 {
+  clearCutInfo(range, pos6, bid6, tri6);
+
+  if (bvh) {
+    Collector f(this, center, range, pos6, true);
+    bvh->query(f.min, f.max, f);
+    f.flush();
+    f.setResult(bid6, tri6);
+    return;
+  }
+
   Vec3r min(center[X]-range[X_M], center[Y]-range[Y_M], center[Z]-range[Z_M]);
   Vec3r max(center[X]+range[X_P], center[Y]+range[Y_P], center[Z]+range[Z_P]);
 
-  clearCutInfo(range, pos6, bid6, tri6);
-
   std::vector<std::string>::const_iterator pg;
   for (pg = pgList->begin(); pg != pgList->end(); ++pg) {
 
@@ -74,6 +143,40 @@ void CutSearch::search(const double center[], const double range[],
 }
 
 
+/// 最近接交点の探索(空間インデクスまたはBVHを使用).
+///
+///  @param[in] i,j,k  3次元インデックス
+///  @param[in] center 計算基準点座標
+///  @param[in] range  6方向毎の計算基準線分の長さ
+///  @param[out] pos6  交点座標値配列
+///  @param[out] bid6  境界ID配列
+///  @param[out] tri6  交点ポリゴンポインタ配列
+///
+///  @note pos6には計算基準線分長で規格化する前の値を格納
+///
+void CutSearch::search(int i, int j, int k,
+                       const double center[], const double range[],
+                       double pos6[], BidType bid6[],
+                       Triangle* tri6[]) const
+{
+  if (!index) {
+    search(center, range, pos6, bid6, tri6);
+    return;
+  }
+
+  clearCutInfo(range, pos6, bid6, tri6);
+
+  // ブリックの三角形番号リストは昇順
+  Collector f(this, center, range, pos6, false);
+  const int* t;
+  const int* tEnd;
+  index->getBin(i, j, k, t, tEnd);
+  for (; t != tEnd; ++t) f(*t);
+  f.flush();
+  f.setResult(bid6, tri6);
+}
+
+
 /// 三角形ポリゴンの交点調査.
 ///
 ///  @param[in] t      対象三角形ポリゴン
@@ -154,4 +257,27 @@ void CutSearch::checkTriangle(Triangle* t, BidType bid,
 }
 
 
+/// 複数の三角形ポリゴンの交点調査(三角形ポリゴンキャッシュを使用).
+///
+///  同じ距離の交点は三角形番号の小さい方を採用する
+///
+///  @param[in] n      三角形数
+///  @param[in] t      三角形番号配列(昇順)
+///  @param[in] center 計算基準点座標
+///  @param[in,out] pos6  交点座標値配列
+///  @param[in,out] t6    交点の三角形番号配列(交点なしは-1)
+///
+///  @note pos6には計算基準線分長で規格化する前の値を格納
+///
+void CutSearch::checkTriangles(int n, const int t[], const double center[],
+                               double pos6[], int t6[]) const
+{
+  const CutTriangleCache* cache = store->getCache();
+
+  for (int a = 0; a < 3; a++) {
+    cache->nearest(a, center, n, t, pos6[2*a], t6[2*a], pos6[2*a+1], t6[2*a+1]);
+  }
+}
+
+
 } // namespace cutlib
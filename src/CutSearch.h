@@ -27,6 +27,8 @@
 
 #include "GridAccessor/GridAccessor.h"
 #include "CutInfo/CutInfoArray.h"
+#include "CutBinIndex.h"
+#include "CutBvh.h"
 
 #include "Polylib.h"
 using namespace PolylibNS;
@@ -38,18 +40,39 @@ class CutSearch {
 
   const Polylib* pl;    ///< Polylibクラスオブジェクト
   const std::vector<std::string>* pgList; ///< ポリゴングループ(パス名)リスト
+  const CutBinIndex* index;  ///< 三角形ポリゴン空間インデクス
+  const CutBvh* bvh;         ///< 三角形ポリゴンBVH
+  const CutTriangleStore* store;  ///< 計算対象三角形ポリゴン(index,bvh使用時)
 
   enum { X, Y, Z};
 
+  class Collector;
+
 public:
 
   /// コンストラクタ.
   ///
   ///  @param[in] pl Polylibクラスオブジェクト
-  ///  @param[in] bList (境界ID,ポリゴングループ名)対応リスト
+  ///  @param[in] pgList ポリゴングループ(パス名)リスト
   ///
   CutSearch(const Polylib* pl, const std::vector<std::string>* pgList)
-    : pl(pl), pgList(pgList) {}
+    : pl(pl), pgList(pgList), index(0), bvh(0), store(0) {}
+
+
+  /// コンストラクタ(空間インデクスを使用).
+  ///
+  ///  @param[in] index 三角形ポリゴン空間インデクス
+  ///
+  CutSearch(const CutBinIndex* index)
+    : pl(0), pgList(0), index(index), bvh(0), store(index->getStore()) {}
+
+
+  /// コンストラクタ(BVHを使用).
+  ///
+  ///  @param[in] bvh 三角形ポリゴンBVH
+  ///
+  CutSearch(const CutBvh* bvh)
+    : pl(0), pgList(0), index(0), bvh(bvh), store(bvh->getStore()) {}
 
 
   /// デストラクタ.
@@ -58,6 +81,8 @@ public:
 
   /// 最近接交点の探索.
   ///
+  ///  BVH使用時はBVHを，それ以外はPolylibの検索メソッドを使用
+  ///
   ///  @param[in] center 計算基準点座標
   ///  @param[in] range  6方向毎の計算基準線分の長さ
   ///  @param[out] pos6  交点座標値配列
@@ -70,6 +95,22 @@ public:
               double pos6[], BidType bid6[], Triangle* tri6[]) const;
 
 
+  /// 最近接交点の探索(空間インデクスまたはBVHを使用).
+  ///
+  ///  @param[in] i,j,k  3次元インデックス
+  ///  @param[in] center 計算基準点座標
+  ///  @param[in] range  6方向毎の計算基準線分の長さ
+  ///  @param[out] pos6  交点座標値配列
+  ///  @param[out] bid6  境界ID配列
+  ///  @param[out] tri6  交点ポリゴンポインタ配列
+  ///
+  ///  @note pos6には計算基準線分長で規格化する前の値を格納
+  ///
+  void search(int i, int j, int k,
+              const double center[], const double range[],
+              double pos6[], BidType bid6[], Triangle* tri6[]) const;
+
+
   /// 三角形ポリゴンの交点調査.
   ///
   ///  @param[in] t      対象三角形ポリゴン
@@ -88,6 +129,22 @@ public:
                             Triangle* tri6[]);
 
 
+  /// 複数の三角形ポリゴンの交点調査(三角形ポリゴンキャッシュを使用).
+  ///
+  ///  同じ距離の交点は三角形番号の小さい方を採用する
+  ///
+  ///  @param[in] n      三角形数
+  ///  @param[in] t      三角形番号配列(昇順)
+  ///  @param[in] center 計算基準点座標
+  ///  @param[in,out] pos6  交点座標値配列
+  ///  @param[in,out] t6    交点の三角形番号配列(交点なしは-1)
+  ///
+  ///  @note pos6には計算基準線分長で規格化する前の値を格納
+  ///
+  void checkTriangles(int n, const int t[], const double center[],
+                      double pos6[], int t6[]) const;
+
+
   /// 交点情報配列の初期化.
   ///
   ///  @param[in] range  6方向毎の計算基準線分の長さ
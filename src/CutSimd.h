@@ -0,0 +1,293 @@
+/*
+###################################################################################
+#
+# Cutlib - Cut Information Library
+#
+# Copyright (c) 2010-2011 VCAD System Research Program, RIKEN.
+# All rights reserved.
+#
+# Copyright (c) 2012-2015 Advanced Institute for Computational Science, RIKEN.
+# All rights reserved.
+#
+# Copyright (c) 2016-2017 Research Institute for Information Technology (RIIT), Kyushu University.
+# All rights reserved.
+#
+###################################################################################
+*/
+
+/// @file
+/// @brief 倍精度SIMD演算ラッパ
+///
+///  コンパイル時に有効な命令セット毎に演算クラスを定義する.
+///   - CutSimdAvx512(__AVX512F__): 8並列
+///   - CutSimdAvx(__AVX__): 4並列(__AVX2__ではgather命令を使用)
+///   - CutSimdSse2(__SSE2__): 2並列
+///   - CutSimdNeon(__aarch64__): 2並列
+///   - CutSimdScalar: スカラ(1並列)
+///  CutSimdはその中で最も並列数の大きいクラスを指す
+///  (CUTLIB_NO_SIMD定義時はCutSimdScalar).
+///
+///  比較演算は全てIEEE754の順序付き比較(NaNを含む時は偽)で，
+///  neqのみ非順序比較(NaNを含む時は真)とする.
+///
+///  @note 命令セット別にコンパイルする翻訳単位(CutTriangleKernel*.cpp)でのみ
+///        インクルードすること.
+///        演算クラスは無名名前空間に置き，異なる命令セットでコンパイルされた
+///        インライン関数がリンク時に混在しないようにする
+///
+
+#ifndef CUTLIB_SIMD_H
+#define CUTLIB_SIMD_H
+
+#if !defined(CUTLIB_NO_SIMD) && (defined(__AVX__) || defined(__AVX512F__))
+#include <immintrin.h>
+#elif !defined(CUTLIB_NO_SIMD) && defined(__SSE2__)
+#include <emmintrin.h>
+#elif !defined(CUTLIB_NO_SIMD) && defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace cutlib {
+
+namespace {
+
+/// 倍精度SIMD演算ラッパクラス(スカラ).
+struct CutSimdScalar {
+
+  enum { Width = 1 };  ///< 並列数
+  typedef double Real;  ///< 倍精度ベクトル
+  typedef bool Mask;  ///< 比較結果マスク
+
+    /// 命令セット名を得る.
+  static const char* name() { return "scalar"; }
+
+  static Real set1(double x) { return x; }
+  static Real load(const double* p) { return *p; }
+  static void store(double* p, Real x) { *p = x; }
+
+  /// base[idx[0]],...,base[idx[Width-1]]を読み込む.
+  static Real gather(const double* base, const int* idx) { return base[idx[0]]; }
+
+  static Real add(Real x, Real y) { return x + y; }
+  static Real sub(Real x, Real y) { return x - y; }
+  static Real mul(Real x, Real y) { return x * y; }
+  static Real div(Real x, Real y) { return x / y; }
+
+  static Mask lt(Real x, Real y) { return x < y; }
+  static Mask le(Real x, Real y) { return x <= y; }
+  static Mask gt(Real x, Real y) { return x > y; }
+  static Mask ge(Real x, Real y) { return x >= y; }
+  static Mask eq(Real x, Real y) { return x == y; }
+  static Mask neq(Real x, Real y) { return !(x == y); }
+
+  static Mask mand(Mask m1, Mask m2) { return m1 && m2; }
+  static Mask mor(Mask m1, Mask m2) { return m1 || m2; }
+  static Mask mandnot(Mask m1, Mask m2) { return !m1 && m2; }
+  static bool any(Mask m) { return m; }
+
+  /// m ? x : y
+  static Real select(Mask m, Real x, Real y) { return m ? x : y; }
+
+};
+
+#if !defined(CUTLIB_NO_SIMD) && defined(__SSE2__)
+
+/// 倍精度SIMD演算ラッパクラス(SSE2).
+struct CutSimdSse2 {
+
+  enum { Width = 2 };
+  typedef __m128d Real;
+  typedef __m128d Mask;
+
+    static const char* name() { return "SSE2"; }
+
+  static Real set1(double x) { return _mm_set1_pd(x); }
+  static Real load(const double* p) { return _mm_loadu_pd(p); }
+  static void store(double* p, Real x) { _mm_storeu_pd(p, x); }
+
+  static Real gather(const double* base, const int* idx) {
+    return _mm_set_pd(base[idx[1]], base[idx[0]]);
+  }
+
+  static Real add(Real x, Real y) { return _mm_add_pd(x, y); }
+  static Real sub(Real x, Real y) { return _mm_sub_pd(x, y); }
+  static Real mul(Real x, Real y) { return _mm_mul_pd(x, y); }
+  static Real div(Real x, Real y) { return _mm_div_pd(x, y); }
+
+  static Mask lt(Real x, Real y) { return _mm_cmplt_pd(x, y); }
+  static Mask le(Real x, Real y) { return _mm_cmple_pd(x, y); }
+  static Mask gt(Real x, Real y) { return _mm_cmpgt_pd(x, y); }
+  static Mask ge(Real x, Real y) { return _mm_cmpge_pd(x, y); }
+  static Mask eq(Real x, Real y) { return _mm_cmpeq_pd(x, y); }
+  static Mask neq(Real x, Real y) { return _mm_cmpneq_pd(x, y); }
+
+  static Mask mand(Mask m1, Mask m2) { return _mm_and_pd(m1, m2); }
+  static Mask mor(Mask m1, Mask m2) { return _mm_or_pd(m1, m2); }
+  static Mask mandnot(Mask m1, Mask m2) { return _mm_andnot_pd(m1, m2); }
+  static bool any(Mask m) { return _mm_movemask_pd(m) != 0; }
+
+  static Real select(Mask m, Real x, Real y) {
+    return _mm_or_pd(_mm_and_pd(m, x), _mm_andnot_pd(m, y));
+  }
+
+};
+
+#endif
+
+#if !defined(CUTLIB_NO_SIMD) && defined(__AVX__)
+
+/// 倍精度SIMD演算ラッパクラス(AVX,AVX2).
+struct CutSimdAvx {
+
+  enum { Width = 4 };
+  typedef __m256d Real;
+  typedef __m256d Mask;
+
+    static const char* name() { return "AVX"; }
+
+  static Real set1(double x) { return _mm256_set1_pd(x); }
+  static Real load(const double* p) { return _mm256_loadu_pd(p); }
+  static void store(double* p, Real x) { _mm256_storeu_pd(p, x); }
+
+  static Real gather(const double* base, const int* idx) {
+#ifdef __AVX2__
+    Real zero = _mm256_setzero_pd();
+    return _mm256_mask_i32gather_pd(zero, base, _mm_loadu_si128((const __m128i*)idx),
+                                    _mm256_cmp_pd(zero, zero, _CMP_EQ_OQ), 8);
+#else
+    return _mm256_set_pd(base[idx[3]], base[idx[2]], base[idx[1]], base[idx[0]]);
+#endif
+  }
+
+  static Real add(Real x, Real y) { return _mm256_add_pd(x, y); }
+  static Real sub(Real x, Real y) { return _mm256_sub_pd(x, y); }
+  static Real mul(Real x, Real y) { return _mm256_mul_pd(x, y); }
+  static Real div(Real x, Real y) { return _mm256_div_pd(x, y); }
+
+  static Mask lt(Real x, Real y) { return _mm256_cmp_pd(x, y, _CMP_LT_OQ); }
+  static Mask le(Real x, Real y) { return _mm256_cmp_pd(x, y, _CMP_LE_OQ); }
+  static Mask gt(Real x, Real y) { return _mm256_cmp_pd(x, y, _CMP_GT_OQ); }
+  static Mask ge(Real x, Real y) { return _mm256_cmp_pd(x, y, _CMP_GE_OQ); }
+  static Mask eq(Real x, Real y) { return _mm256_cmp_pd(x, y, _CMP_EQ_OQ); }
+  static Mask neq(Real x, Real y) { return _mm256_cmp_pd(x, y, _CMP_NEQ_UQ); }
+
+  static Mask mand(Mask m1, Mask m2) { return _mm256_and_pd(m1, m2); }
+  static Mask mor(Mask m1, Mask m2) { return _mm256_or_pd(m1, m2); }
+  static Mask mandnot(Mask m1, Mask m2) { return _mm256_andnot_pd(m1, m2); }
+  static bool any(Mask m) { return _mm256_movemask_pd(m) != 0; }
+
+  static Real select(Mask m, Real x, Real y) { return _mm256_blendv_pd(y, x, m); }
+
+};
+
+#endif
+
+#if !defined(CUTLIB_NO_SIMD) && defined(__AVX512F__)
+
+/// 倍精度SIMD演算ラッパクラス(AVX-512).
+struct CutSimdAvx512 {
+
+  enum { Width = 8 };
+  typedef __m512d Real;
+  typedef __mmask8 Mask;
+
+    static const char* name() { return "AVX-512"; }
+
+  static Real set1(double x) { return _mm512_set1_pd(x); }
+  static Real load(const double* p) { return _mm512_loadu_pd(p); }
+  static void store(double* p, Real x) { _mm512_storeu_pd(p, x); }
+
+  static Real gather(const double* base, const int* idx) {
+    return _mm512_mask_i32gather_pd(_mm512_setzero_pd(), 0xff,
+                                    _mm256_loadu_si256((const __m256i*)idx), base, 8);
+  }
+
+  static Real add(Real x, Real y) { return _mm512_add_pd(x, y); }
+  static Real sub(Real x, Real y) { return _mm512_sub_pd(x, y); }
+  static Real mul(Real x, Real y) { return _mm512_mul_pd(x, y); }
+  static Real div(Real x, Real y) { return _mm512_div_pd(x, y); }
+
+  static Mask lt(Real x, Real y) { return _mm512_cmp_pd_mask(x, y, _CMP_LT_OQ); }
+  static Mask le(Real x, Real y) { return _mm512_cmp_pd_mask(x, y, _CMP_LE_OQ); }
+  static Mask gt(Real x, Real y) { return _mm512_cmp_pd_mask(x, y, _CMP_GT_OQ); }
+  static Mask ge(Real x, Real y) { return _mm512_cmp_pd_mask(x, y, _CMP_GE_OQ); }
+  static Mask eq(Real x, Real y) { return _mm512_cmp_pd_mask(x, y, _CMP_EQ_OQ); }
+  static Mask neq(Real x, Real y) { return _mm512_cmp_pd_mask(x, y, _CMP_NEQ_UQ); }
+
+  static Mask mand(Mask m1, Mask m2) { return (Mask)(m1 & m2); }
+  static Mask mor(Mask m1, Mask m2) { return (Mask)(m1 | m2); }
+  static Mask mandnot(Mask m1, Mask m2) { return (Mask)(~m1 & m2); }
+  static bool any(Mask m) { return m != 0; }
+
+  static Real select(Mask m, Real x, Real y) { return _mm512_mask_blend_pd(m, y, x); }
+
+};
+
+#endif
+
+#if !defined(CUTLIB_NO_SIMD) && defined(__aarch64__) && defined(__ARM_NEON)
+
+/// 倍精度SIMD演算ラッパクラス(NEON).
+struct CutSimdNeon {
+
+  enum { Width = 2 };
+  typedef float64x2_t Real;
+  typedef uint64x2_t Mask;
+
+    static const char* name() { return "NEON"; }
+
+  static Real set1(double x) { return vdupq_n_f64(x); }
+  static Real load(const double* p) { return vld1q_f64(p); }
+  static void store(double* p, Real x) { vst1q_f64(p, x); }
+
+  static Real gather(const double* base, const int* idx) {
+    return vsetq_lane_f64(base[idx[1]], vdupq_n_f64(base[idx[0]]), 1);
+  }
+
+  static Real add(Real x, Real y) { return vaddq_f64(x, y); }
+  static Real sub(Real x, Real y) { return vsubq_f64(x, y); }
+  static Real mul(Real x, Real y) { return vmulq_f64(x, y); }
+  static Real div(Real x, Real y) { return vdivq_f64(x, y); }
+
+  static Mask lt(Real x, Real y) { return vcltq_f64(x, y); }
+  static Mask le(Real x, Real y) { return vcleq_f64(x, y); }
+  static Mask gt(Real x, Real y) { return vcgtq_f64(x, y); }
+  static Mask ge(Real x, Real y) { return vcgeq_f64(x, y); }
+  static Mask eq(Real x, Real y) { return vceqq_f64(x, y); }
+  static Mask neq(Real x, Real y) {
+    return vreinterpretq_u64_u32(vmvnq_u32(vreinterpretq_u32_u64(vceqq_f64(x, y))));
+  }
+
+  static Mask mand(Mask m1, Mask m2) { return vandq_u64(m1, m2); }
+  static Mask mor(Mask m1, Mask m2) { return vorrq_u64(m1, m2); }
+  static Mask mandnot(Mask m1, Mask m2) { return vbicq_u64(m2, m1); }
+  static bool any(Mask m) {
+    return (vgetq_lane_u64(m, 0) | vgetq_lane_u64(m, 1)) != 0;
+  }
+
+  static Real select(Mask m, Real x, Real y) { return vbslq_f64(m, x, y); }
+
+};
+
+#endif
+
+/// コンパイル時に有効な最大並列数の演算クラス.
+#if defined(CUTLIB_NO_SIMD)
+typedef CutSimdScalar CutSimd;
+#elif defined(__AVX512F__)
+typedef CutSimdAvx512 CutSimd;
+#elif defined(__AVX__)
+typedef CutSimdAvx CutSimd;
+#elif defined(__SSE2__)
+typedef CutSimdSse2 CutSimd;
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+typedef CutSimdNeon CutSimd;
+#else
+typedef CutSimdScalar CutSimd;
+#endif
+
+} // namespace ANONYMOUS
+
+} // namespace cutlib
+
+#endif // CUTLIB_SIMD_H
@@ -38,6 +38,7 @@ enum Section {
   MAIN_LOOP,
   THREAD_TOTAL,
   PACK_NORMAL,
+  BUILD_INDEX,
   TEST1,
   TEST2,
   NumSections,
@@ -130,6 +131,24 @@ class Timer {
     for (int i = 0; i < nThread; i++) print(name, i);
   }
 
+  /// スレッド間の負荷不均衡度(最大/平均)を出力.
+  void printImbalance(const std::string& name) const {
+#ifdef _OPENMP
+    int nThread = omp_get_max_threads();
+#else
+    int nThread = 1;
+#endif
+    double max = 0.0;
+    double sum = 0.0;
+    for (int i = 0; i < nThread; i++) {
+      if (time[i] > max) max = time[i];
+      sum += time[i];
+    }
+    std::cout << name << ": "
+              << "imbalance (max/mean) = "
+              << (sum > 0.0 ? max * nThread / sum : 1.0) << std::endl;
+  }
+
 public:
 
   /// ストップウオッチsecをスタート.
@@ -158,6 +177,15 @@ public:
   ///
   static void PrintFull(Section sec, const std::string& name) { Timers[sec].printFull(name); }
 
+  /// ストップウオッチsecのスレッド間の負荷不均衡度を表示.
+  ///
+  ///  @param[in] sec ストップウオッチキーワード
+  ///  @param[in] name ストップウオッチ名
+  ///
+  static void PrintImbalance(Section sec, const std::string& name) {
+    Timers[sec].printImbalance(name);
+  }
+
 };
 
 } // namespace cutlib
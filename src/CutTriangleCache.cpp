@@ -0,0 +1,71 @@
+/*
+###################################################################################
+#
+# Cutlib - Cut Information Library
+#
+# Copyright (c) 2010-2011 VCAD System Research Program, RIKEN.
+# All rights reserved.
+#
+# Copyright (c) 2012-2015 Advanced Institute for Computational Science, RIKEN.
+# All rights reserved.
+#
+# Copyright (c) 2016-2017 Research Institute for Information Technology (RIIT), Kyushu University.
+# All rights reserved.
+#
+###################################################################################
+*/
+
+/// @file
+/// @brief 交点計算用三角形ポリゴンキャッシュクラス 実装
+///
+
+#include "CutTriangleCache.h"
+
+#ifdef CUTLIB_DEBUG
+#include <iostream>
+#endif
+
+namespace cutlib {
+
+/// コンストラクタ.
+///
+///  @param[in] triList 三角形ポリゴンリスト
+///
+CutTriangleCache::CutTriangleCache(const std::vector<Triangle*>& triList)
+  : nTri(triList.size())
+{
+  for (int i = 0; i < 3; i++) {
+    normal[i].resize(nTri);
+    for (int iv = 0; iv < 3; iv++) vertex[iv][i].resize(nTri);
+  }
+  dot_normal_vertex0.resize(nTri);
+
+#pragma omp parallel for
+  for (long t = 0; t < (long)nTri; t++) {
+    Vertex  n = triList[t]->get_normal();
+    Vertex** v = triList[t]->get_vertex();
+
+    double dot = 0.0;
+    for (int i = 0; i < 3; i++) {
+      normal[i][t] = n[i];
+      vertex[0][i][t] = (*v[0])[i];
+      vertex[1][i][t] = (*v[1])[i];
+      vertex[2][i][t] = (*v[2])[i];
+      dot += normal[i][t] * vertex[0][i][t];
+    }
+    dot_normal_vertex0[t] = dot;
+  }
+
+  for (int i = 0; i < 3; i++) {
+    soa.normal[i] = nTri ? &normal[i][0] : 0;
+    for (int iv = 0; iv < 3; iv++) soa.vertex[iv][i] = nTri ? &vertex[iv][i][0] : 0;
+  }
+  soa.dot = nTri ? &dot_normal_vertex0[0] : 0;
+  kernel = GetTriangleKernel();
+#ifdef CUTLIB_DEBUG
+  std::cout << "CutTriangleCache: " << kernel->name << " kernel, "
+            << kernel->width << " lanes" << std::endl;
+#endif
+}
+
+} // namespace cutlib
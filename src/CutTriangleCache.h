@@ -0,0 +1,141 @@
+/*
+###################################################################################
+#
+# Cutlib - Cut Information Library
+#
+# Copyright (c) 2010-2011 VCAD System Research Program, RIKEN.
+# All rights reserved.
+#
+# Copyright (c) 2012-2015 Advanced Institute for Computational Science, RIKEN.
+# All rights reserved.
+#
+# Copyright (c) 2016-2017 Research Institute for Information Technology (RIIT), Kyushu University.
+# All rights reserved.
+#
+###################################################################################
+*/
+
+/// @file
+/// @brief 交点計算用三角形ポリゴンキャッシュクラス 宣言
+///
+
+#ifndef CUTLIB_TRIANGLE_CACHE_H
+#define CUTLIB_TRIANGLE_CACHE_H
+
+#include <vector>
+#include <limits>   // for quiet_NaN
+
+#include "CutTriangleKernel.h"
+
+#include "Polylib.h"
+using namespace PolylibNS;
+
+namespace cutlib {
+
+/// 交点計算用三角形ポリゴンキャッシュクラス.
+///
+///  TargetTriangleと同じ前処理(倍精度への変換,法線ベクトルと頂点の内積)を
+///  三角形ポリゴン毎に一度だけ行い，成分毎の配列(SoA)として保持する.
+///  交点計算は三角形番号で参照し，TargetTriangleと同一の演算順で評価する.
+///  一括交点計算には実行中のCPUに合わせて選択したSIMDカーネルを使用する.
+///
+class CutTriangleCache {
+
+  enum { X, Y, Z };
+
+  size_t nTri;  ///< 三角形ポリゴン数
+
+  std::vector<double> normal[3];     ///< 法線ベクトル[方向]
+  std::vector<double> vertex[3][3];  ///< 頂点座標[頂点][方向]
+  std::vector<double> dot_normal_vertex0;  ///< 法線ベクトルと頂点0の内積値
+
+  CutTriangleSoA soa;                 ///< 成分毎の配列の先頭ポインタ
+  const CutTriangleKernel* kernel;    ///< 一括交点計算カーネル
+
+public:
+
+  /// コンストラクタ.
+  ///
+  ///  @param[in] triList 三角形ポリゴンリスト
+  ///
+  CutTriangleCache(const std::vector<Triangle*>& triList);
+
+  /// デストラクタ.
+  ~CutTriangleCache() {}
+
+  /// 三角形ポリゴン数を得る.
+  size_t getNumTriangle() const { return nTri; }
+
+  /// 一括交点計算カーネルを得る.
+  const CutTriangleKernel* getKernel() const { return kernel; }
+
+  /// a方向の直線との交点を計算.
+  ///
+  ///  @param[in] t 三角形番号
+  ///  @param[in] a 直線の方向(X,Y,Z)
+  ///  @param[in] pb,pc 直線位置((a+1)%3方向,(a+2)%3方向の座標)
+  ///  @param[out] p  交点座標
+  ///  @return true:交点あり/false:交点なし
+  ///
+  ///  @note TargetTriangle::intersectX/Y/Zと同じ結果を返す
+  ///
+  bool intersect(int t, int a, double pb, double pc, double& p) const {
+    int b = (a + 1) % 3;
+    int c = (a + 2) % 3;
+    double n = normal[a][t];
+    if (n == 0.0) return false;
+
+    double v0b = vertex[0][b][t], v0c = vertex[0][c][t];
+    double v1b = vertex[1][b][t], v1c = vertex[1][c][t];
+    double v2b = vertex[2][b][t], v2c = vertex[2][c][t];
+
+    double c0 = (v1b - v0b) * (pc - v0c) - (v1c - v0c) * (pb - v0b);
+    double c1 = (v2b - v1b) * (pc - v1c) - (v2c - v1c) * (pb - v1b);
+    double c2 = (v0b - v2b) * (pc - v2c) - (v0c - v2c) * (pb - v2b);
+    if (n > 0.0) {
+      if (c0 < 0.0 || c1 < 0.0 || c2 < 0.0) return false;
+    } else {
+      if (c0 > 0.0 || c1 > 0.0 || c2 > 0.0) return false;
+    }
+
+    p = (dot_normal_vertex0[t] - normal[b][t]*pb - normal[c][t]*pc) / n;
+
+    return true;
+  }
+
+  /// 複数の三角形ポリゴンとa方向の直線との交点を一括計算.
+  ///
+  ///  @param[in] a 直線の方向(X,Y,Z)
+  ///  @param[in] pb,pc 直線位置((a+1)%3方向,(a+2)%3方向の座標)
+  ///  @param[in] n 三角形数
+  ///  @param[in] t 三角形番号配列
+  ///  @param[out] p 交点座標配列(交点なしの時はNaN)
+  ///
+  void intersect(int a, double pb, double pc, int n, const int t[],
+                 double p[]) const {
+    kernel->intersect(soa, a, pb, pc, n, t, p,
+                      std::numeric_limits<double>::quiet_NaN());
+  }
+
+  /// 複数の三角形ポリゴンについてa方向の最近接交点を一括探索.
+  ///
+  ///  同じ距離では三角形番号の小さい方を採用する.
+  ///  既に設定済みの交点(tM,tP >= 0)とも三角形番号で比較する
+  ///
+  ///  @param[in] a 方向(X,Y,Z)
+  ///  @param[in] center 計算基準点座標
+  ///  @param[in] n 三角形数
+  ///  @param[in] t 三角形番号配列(昇順)
+  ///  @param[in,out] posM,posP 負/正方向の交点距離(これより近い交点のみ採用)
+  ///  @param[in,out] tM,tP 負/正方向の交点の三角形番号(更新時のみ設定)
+  ///
+  void nearest(int a, const double center[], int n, const int t[],
+               double& posM, int& tM, double& posP, int& tP) const {
+    kernel->nearest(soa, a, center, n, t, posM, tM, posP, tP);
+  }
+
+};
+
+} // namespace cutlib
+
+#endif // CUTLIB_TRIANGLE_CACHE_H
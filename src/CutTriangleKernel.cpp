@@ -0,0 +1,57 @@
+/*
+###################################################################################
+#
+# Cutlib - Cut Information Library
+#
+# Copyright (c) 2010-2011 VCAD System Research Program, RIKEN.
+# All rights reserved.
+#
+# Copyright (c) 2012-2015 Advanced Institute for Computational Science, RIKEN.
+# All rights reserved.
+#
+# Copyright (c) 2016-2017 Research Institute for Information Technology (RIIT), Kyushu University.
+# All rights reserved.
+#
+###################################################################################
+*/
+
+/// @file
+/// @brief 三角形ポリゴン一括交点計算カーネル(ライブラリ全体と同じ命令セット) 実装
+///
+
+#include "CutTriangleKernel.h"
+#include "CutSimd.h"
+#include "CutTriangleKernelT.h"
+
+namespace cutlib {
+
+/// ライブラリ全体と同じ命令セットのカーネルを得る.
+const CutTriangleKernel* GetTriangleKernelDefault()
+{
+  static const CutTriangleKernel kernel = CutTriangleKernelT<CutSimd>::get();
+  return &kernel;
+}
+
+
+/// 実行中のCPUで使用可能な最大並列数のカーネルを得る.
+///
+///  x86ではCPUの対応命令を調べ，AVX-512,AVX2のカーネルが有効なら使用する.
+///  CUTLIB_NO_SIMD定義時は常にスカラのカーネルを使用する
+///
+const CutTriangleKernel* GetTriangleKernel()
+{
+  const CutTriangleKernel* kernel = GetTriangleKernelDefault();
+#if !defined(CUTLIB_NO_SIMD) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+  __builtin_cpu_init();
+  const CutTriangleKernel* avx512 = GetTriangleKernelAvx512();
+  const CutTriangleKernel* avx2 = GetTriangleKernelAvx2();
+  if (avx512 && __builtin_cpu_supports("avx512f") && avx512->width > kernel->width) {
+    kernel = avx512;
+  } else if (avx2 && __builtin_cpu_supports("avx2") && avx2->width > kernel->width) {
+    kernel = avx2;
+  }
+#endif
+  return kernel;
+}
+
+} // namespace cutlib
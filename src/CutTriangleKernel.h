@@ -0,0 +1,97 @@
+/*
+###################################################################################
+#
+# Cutlib - Cut Information Library
+#
+# Copyright (c) 2010-2011 VCAD System Research Program, RIKEN.
+# All rights reserved.
+#
+# Copyright (c) 2012-2015 Advanced Institute for Computational Science, RIKEN.
+# All rights reserved.
+#
+# Copyright (c) 2016-2017 Research Institute for Information Technology (RIIT), Kyushu University.
+# All rights reserved.
+#
+###################################################################################
+*/
+
+/// @file
+/// @brief 三角形ポリゴン一括交点計算カーネル 宣言
+///
+///  カーネルは命令セット別の翻訳単位でコンパイルし，
+///  実行時にCPUが対応する最大並列数のものを選択する.
+///   - CutTriangleKernelAvx512.cpp: AVX-512(-mavx512fでコンパイル)
+///   - CutTriangleKernelAvx2.cpp: AVX2(-mavx2でコンパイル)
+///   - CutTriangleKernel.cpp: ライブラリ全体と同じ命令セット
+///  命令セット別のカーネルは，対応するフラグなしでコンパイルされた時は
+///  無効(取得関数が0を返す)となる.
+///
+///  @note 演算結果が命令セットに依らず一致するよう，
+///        カーネルは積和演算の融合(FMA)なしでコンパイルすること
+///        (-ffp-contract=off)
+///
+
+#ifndef CUTLIB_TRIANGLE_KERNEL_H
+#define CUTLIB_TRIANGLE_KERNEL_H
+
+namespace cutlib {
+
+/// 一括交点計算で参照する三角形ポリゴンデータ(成分毎の配列).
+struct CutTriangleSoA {
+  const double* normal[3];     ///< 法線ベクトル[方向]
+  const double* vertex[3][3];  ///< 頂点座標[頂点][方向]
+  const double* dot;           ///< 法線ベクトルと頂点0の内積値
+};
+
+
+/// 三角形ポリゴン一括交点計算カーネル.
+struct CutTriangleKernel {
+
+  const char* name;  ///< 命令セット名
+  int width;         ///< SIMD並列数
+
+  /// 複数の三角形ポリゴンとa方向の直線との交点を一括計算.
+  ///
+  ///  @param[in] soa 三角形ポリゴンデータ
+  ///  @param[in] a 直線の方向(X,Y,Z)
+  ///  @param[in] pb,pc 直線位置((a+1)%3方向,(a+2)%3方向の座標)
+  ///  @param[in] n 三角形数
+  ///  @param[in] t 三角形番号配列
+  ///  @param[out] p 交点座標配列
+  ///  @param[in] miss 交点なしの時にpに設定する値
+  ///
+  void (*intersect)(const CutTriangleSoA& soa, int a, double pb, double pc,
+                    int n, const int t[], double p[], double miss);
+
+  /// 複数の三角形ポリゴンについてa方向の最近接交点を一括探索.
+  ///
+  ///  @param[in] soa 三角形ポリゴンデータ
+  ///  @param[in] a 方向(X,Y,Z)
+  ///  @param[in] center 計算基準点座標
+  ///  @param[in] n 三角形数
+  ///  @param[in] t 三角形番号配列(昇順)
+  ///  @param[in,out] posM,posP 負/正方向の交点距離(これより近い交点のみ採用)
+  ///  @param[in,out] tM,tP 負/正方向の交点の三角形番号(更新時のみ設定)
+  ///
+  void (*nearest)(const CutTriangleSoA& soa, int a, const double center[],
+                  int n, const int t[],
+                  double& posM, int& tM, double& posP, int& tP);
+
+};
+
+
+/// ライブラリ全体と同じ命令セットのカーネルを得る.
+const CutTriangleKernel* GetTriangleKernelDefault();
+
+/// AVX2カーネルを得る(無効な時は0).
+const CutTriangleKernel* GetTriangleKernelAvx2();
+
+/// AVX-512カーネルを得る(無効な時は0).
+const CutTriangleKernel* GetTriangleKernelAvx512();
+
+/// 実行中のCPUで使用可能な最大並列数のカーネルを得る.
+const CutTriangleKernel* GetTriangleKernel();
+
+} // namespace cutlib
+
+#endif // CUTLIB_TRIANGLE_KERNEL_H
@@ -0,0 +1,56 @@
+/*
+###################################################################################
+#
+# Cutlib - Cut Information Library
+#
+# Copyright (c) 2010-2011 VCAD System Research Program, RIKEN.
+# All rights reserved.
+#
+# Copyright (c) 2012-2015 Advanced Institute for Computational Science, RIKEN.
+# All rights reserved.
+#
+# Copyright (c) 2016-2017 Research Institute for Information Technology (RIIT), Kyushu University.
+# All rights reserved.
+#
+###################################################################################
+*/
+
+/// @file
+/// @brief 三角形ポリゴン一括交点計算カーネル(AVX-512) 実装
+///
+///  AVX-512を有効にするフラグでコンパイルした時のみカーネルを定義する.
+///  この翻訳単位ではカーネル以外のインライン関数を使用しないこと
+///  (異なる命令セットのコードがリンク時に選ばれるのを避けるため)
+///
+
+#include "CutTriangleKernel.h"
+
+#if !defined(CUTLIB_NO_SIMD) && defined(__AVX512F__)
+
+#include "CutSimd.h"
+#include "CutTriangleKernelT.h"
+
+namespace cutlib {
+
+/// AVX-512カーネルを得る(無効な時は0).
+const CutTriangleKernel* GetTriangleKernelAvx512()
+{
+  static const CutTriangleKernel kernel = CutTriangleKernelT<CutSimdAvx512>::get();
+  return &kernel;
+}
+
+} // namespace cutlib
+
+#else
+
+namespace cutlib {
+
+/// AVX-512カーネルを得る(無効な時は0).
+const CutTriangleKernel* GetTriangleKernelAvx512()
+{
+  return 0;
+}
+
+} // namespace cutlib
+
+#endif
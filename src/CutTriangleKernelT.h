@@ -0,0 +1,272 @@
+/*
+###################################################################################
+#
+# Cutlib - Cut Information Library
+#
+# Copyright (c) 2010-2011 VCAD System Research Program, RIKEN.
+# All rights reserved.
+#
+# Copyright (c) 2012-2015 Advanced Institute for Computational Science, RIKEN.
+# All rights reserved.
+#
+# Copyright (c) 2016-2017 Research Institute for Information Technology (RIIT), Kyushu University.
+# All rights reserved.
+#
+###################################################################################
+*/
+
+/// @file
+/// @brief 三角形ポリゴン一括交点計算カーネル テンプレート実装
+///
+///  命令セット別の翻訳単位からCutSimd.hの後にインクルードし，
+///  演算クラスを指定して実体化する.
+///
+
+#ifndef CUTLIB_TRIANGLE_KERNEL_T_H
+#define CUTLIB_TRIANGLE_KERNEL_T_H
+
+#include "CutTriangleKernel.h"
+
+namespace cutlib {
+
+namespace {
+
+/// 三角形ポリゴン一括交点計算カーネルクラステンプレート.
+///
+///  @tparam S 倍精度SIMD演算クラス(CutSimd.h)
+///
+///  三角形データは三角形番号で成分毎の配列から直接SIMDレーンに読み込む.
+///  演算順はTargetTriangle,CutTriangleCache::intersectと同一で，
+///  結果は命令セットに依らずスカラ計算と一致する.
+///
+template<typename S>
+struct CutTriangleKernelT {
+
+  typedef typename S::Real Real;
+  typedef typename S::Mask Mask;
+
+  /// SIMD演算1回分の三角形データ.
+  struct Batch {
+    Real n, nb, nc, dot;
+    Real v0b, v0c, v1b, v1c, v2b, v2c;
+  };
+
+  /// 三角形データをSIMDレーンに読み込む.
+  ///
+  ///  @param[in] soa 三角形ポリゴンデータ
+  ///  @param[in] a 直線の方向(X,Y,Z)
+  ///  @param[in] t 三角形番号配列(Width要素)
+  ///  @param[out] batch 三角形データ
+  ///
+  static void gather(const CutTriangleSoA& soa, int a, const int t[],
+                     Batch& batch) {
+    int b = (a + 1) % 3;
+    int c = (a + 2) % 3;
+    batch.n   = S::gather(soa.normal[a], t);
+    batch.nb  = S::gather(soa.normal[b], t);
+    batch.nc  = S::gather(soa.normal[c], t);
+    batch.dot = S::gather(soa.dot, t);
+    batch.v0b = S::gather(soa.vertex[0][b], t);
+    batch.v0c = S::gather(soa.vertex[0][c], t);
+    batch.v1b = S::gather(soa.vertex[1][b], t);
+    batch.v1c = S::gather(soa.vertex[1][c], t);
+    batch.v2b = S::gather(soa.vertex[2][b], t);
+    batch.v2c = S::gather(soa.vertex[2][c], t);
+  }
+
+  /// 端数処理用の三角形番号配列を作成.
+  ///
+  ///  Width未満の残りのレーンには先頭の三角形番号を入れる
+  ///  (結果は呼び出し側で除外する)
+  ///
+  ///  @param[in] n 三角形数(Width未満)
+  ///  @param[in] t 三角形番号配列
+  ///  @param[out] idx 三角形番号配列(Width要素)
+  ///
+  static void pad(int n, const int t[], int idx[]) {
+    for (int l = 0; l < S::Width; l++) idx[l] = t[l < n ? l : 0];
+  }
+
+  /// SIMD演算1回分の交点計算.
+  ///
+  ///  TargetTriangle::existIntersectionの分岐をマスク演算で表す.
+  ///  法線ベクトルのa成分が0のレーンは交点なし
+  ///
+  ///  @param[in] batch 三角形データ
+  ///  @param[in] pb,pc 直線位置
+  ///  @param[out] p 交点座標
+  ///  @return 交点ありのレーンのマスク
+  ///
+  static Mask intersect(const Batch& batch, Real pb, Real pc, Real& p) {
+    Real zero = S::set1(0.0);
+
+    Real c0 = S::sub(S::mul(S::sub(batch.v1b, batch.v0b), S::sub(pc, batch.v0c)),
+                     S::mul(S::sub(batch.v1c, batch.v0c), S::sub(pb, batch.v0b)));
+    Real c1 = S::sub(S::mul(S::sub(batch.v2b, batch.v1b), S::sub(pc, batch.v1c)),
+                     S::mul(S::sub(batch.v2c, batch.v1c), S::sub(pb, batch.v1b)));
+    Real c2 = S::sub(S::mul(S::sub(batch.v0b, batch.v2b), S::sub(pc, batch.v2c)),
+                     S::mul(S::sub(batch.v0c, batch.v2c), S::sub(pb, batch.v2b)));
+
+    Mask anyNeg = S::mor(S::lt(c0, zero), S::mor(S::lt(c1, zero), S::lt(c2, zero)));
+    Mask anyPos = S::mor(S::gt(c0, zero), S::mor(S::gt(c1, zero), S::gt(c2, zero)));
+
+    // normal>0: 全て非負, それ以外(normal!=0): 全て非正
+    Mask nPos = S::gt(batch.n, zero);
+    Mask nOther = S::mandnot(nPos, S::neq(batch.n, zero));
+    Mask hit = S::mor(S::mandnot(anyNeg, nPos), S::mandnot(anyPos, nOther));
+
+    p = S::div(S::sub(S::sub(batch.dot, S::mul(batch.nb, pb)), S::mul(batch.nc, pc)),
+               batch.n);
+
+    return hit;
+  }
+
+  /// 複数の三角形ポリゴンとa方向の直線との交点を一括計算.
+  ///
+  ///  @param[in] soa 三角形ポリゴンデータ
+  ///  @param[in] a 直線の方向(X,Y,Z)
+  ///  @param[in] pb,pc 直線位置((a+1)%3方向,(a+2)%3方向の座標)
+  ///  @param[in] n 三角形数
+  ///  @param[in] t 三角形番号配列
+  ///  @param[out] p 交点座標配列
+  ///  @param[in] miss 交点なしの時にpに設定する値
+  ///
+  static void intersect(const CutTriangleSoA& soa, int a, double pb, double pc,
+                        int n, const int t[], double p[], double miss) {
+    const int W = S::Width;
+    Real vpb = S::set1(pb);
+    Real vpc = S::set1(pc);
+    Real vmiss = S::set1(miss);
+
+    int i = 0;
+    for (; i + W <= n; i += W) {
+      Batch batch;
+      gather(soa, a, t + i, batch);
+      Real vp;
+      Mask hit = intersect(batch, vpb, vpc, vp);
+      S::store(p + i, S::select(hit, vp, vmiss));
+    }
+    if (i < n) {
+      int idx[W];
+      pad(n - i, t + i, idx);
+      Batch batch;
+      gather(soa, a, idx, batch);
+      Real vp;
+      Mask hit = intersect(batch, vpb, vpc, vp);
+      double buf[W];
+      S::store(buf, S::select(hit, vp, vmiss));
+      for (int l = 0; l < n - i; l++) p[i+l] = buf[l];
+    }
+  }
+
+  /// 複数の三角形ポリゴンについてa方向の最近接交点を一括探索.
+  ///
+  ///  レーン毎に最近接交点とその配列位置を保持し，最後にレーン間で
+  ///  距離,三角形番号の順に比較して決定する.
+  ///  既に設定済みの交点と同じ距離の交点もレーンには保持し，
+  ///  最後に三角形番号で比較する
+  ///
+  ///  @param[in] soa 三角形ポリゴンデータ
+  ///  @param[in] a 方向(X,Y,Z)
+  ///  @param[in] center 計算基準点座標
+  ///  @param[in] n 三角形数
+  ///  @param[in] t 三角形番号配列(昇順)
+  ///  @param[in,out] posM,posP 負/正方向の交点距離(これより近い交点のみ採用)
+  ///  @param[in,out] tM,tP 負/正方向の交点の三角形番号(更新時のみ設定)
+  ///
+  static void nearest(const CutTriangleSoA& soa, int a, const double center[],
+                      int n, const int t[],
+                      double& posM, int& tM, double& posP, int& tP) {
+    const int W = S::Width;
+    Real vpa = S::set1(center[a]);
+    Real vpb = S::set1(center[(a+1)%3]);
+    Real vpc = S::set1(center[(a+2)%3]);
+
+    Real bestM = S::set1(posM);
+    Real bestP = S::set1(posP);
+    Real none = S::set1(-1.0);
+    Real idM = none;
+    Real idP = none;
+
+    double lane[W];
+    for (int l = 0; l < W; l++) lane[l] = l;
+    Real vid = S::load(lane);
+    Real vW = S::set1(W);
+    Real vn = S::set1(n);
+
+    for (int i = 0; i < n; i += W) {
+      Batch batch;
+      Real vp;
+      Mask hit;
+      if (i + W <= n) {
+        gather(soa, a, t + i, batch);
+        hit = intersect(batch, vpb, vpc, vp);
+      } else {
+        int idx[W];
+        pad(n - i, t + i, idx);
+        gather(soa, a, idx, batch);
+        hit = S::mand(intersect(batch, vpb, vpc, vp), S::lt(vid, vn));
+      }
+      if (S::any(hit)) {
+        Real dP = S::sub(vp, vpa);
+        Mask nearP = S::mor(S::lt(dP, bestP),
+                            S::mand(S::eq(dP, bestP), S::eq(idP, none)));
+        Mask okP = S::mand(hit, S::mand(S::ge(vp, vpa), nearP));
+        bestP = S::select(okP, dP, bestP);
+        idP = S::select(okP, vid, idP);
+
+        Real dM = S::sub(vpa, vp);
+        Mask nearM = S::mor(S::lt(dM, bestM),
+                            S::mand(S::eq(dM, bestM), S::eq(idM, none)));
+        Mask okM = S::mand(hit, S::mand(S::le(vp, vpa), nearM));
+        bestM = S::select(okM, dM, bestM);
+        idM = S::select(okM, vid, idM);
+      }
+      vid = S::add(vid, vW);
+    }
+
+    reduce(t, bestP, idP, posP, tP);
+    reduce(t, bestM, idM, posM, tM);
+  }
+
+  /// レーン毎の最近接交点から一つを決定.
+  ///
+  ///  @param[in] t 三角形番号配列
+  ///  @param[in] best レーン毎の交点距離
+  ///  @param[in] id レーン毎の交点の配列位置(交点なしの時は負)
+  ///  @param[in,out] pos 交点距離
+  ///  @param[in,out] tri 交点の三角形番号
+  ///
+  static void reduce(const int t[], Real best, Real id,
+                     double& pos, int& tri) {
+    const int W = S::Width;
+    double bestL[W], idL[W];
+    S::store(bestL, best);
+    S::store(idL, id);
+    for (int l = 0; l < W; l++) {
+      if (idL[l] < 0.0) continue;
+      int tl = t[(int)idL[l]];
+      if (bestL[l] < pos || (bestL[l] == pos && tri >= 0 && tl < tri)) {
+        pos = bestL[l];
+        tri = tl;
+      }
+    }
+  }
+
+  /// カーネルを得る.
+  static CutTriangleKernel get() {
+    CutTriangleKernel kernel;
+    kernel.name = S::name();
+    kernel.width = S::Width;
+    kernel.intersect = &CutTriangleKernelT::intersect;
+    kernel.nearest = &CutTriangleKernelT::nearest;
+    return kernel;
+  }
+
+};
+
+} // namespace ANONYMOUS
+
+} // namespace cutlib
+
+#endif // CUTLIB_TRIANGLE_KERNEL_T_H
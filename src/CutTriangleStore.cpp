@@ -0,0 +1,132 @@
+/*
+###################################################################################
+#
+# Cutlib - Cut Information Library
+#
+# Copyright (c) 2010-2011 VCAD System Research Program, RIKEN.
+# All rights reserved.
+#
+# Copyright (c) 2012-2015 Advanced Institute for Computational Science, RIKEN.
+# All rights reserved.
+#
+# Copyright (c) 2016-2017 Research Institute for Information Technology (RIIT), Kyushu University.
+# All rights reserved.
+#
+###################################################################################
+*/
+
+/// @file
+/// @brief 計算対象三角形ポリゴン格納クラス 実装
+///
+
+#include "CutTriangleStore.h"
+
+#ifdef CUTLIB_TIMING
+#include "CutTiming.h"
+#endif
+
+#include <algorithm>   // for min, max
+#include <float.h>     // for FLT_MAX
+#ifdef CUTLIB_DEBUG
+#include <iostream>
+#endif
+
+namespace cutlib {
+
+/// コンストラクタ.
+///
+///  @param[in] pl Polylibクラスオブジェクト
+///  @param[in] pgList 計算対象ポリゴングループのパス名リスト
+///  @param[in] lattice 計算対象領域の直交格子座標テーブル
+///
+CutTriangleStore::CutTriangleStore(const Polylib* pl,
+                                   const std::vector<std::string>* pgList,
+                                   const CutGridLattice* lattice)
+{
+  Vec3r min, max;
+  if (lattice->getDomain(min, max)) collect(pl, pgList, min, max);
+  cache = new CutTriangleCache(triList);
+}
+
+
+/// コンストラクタ(全三角形ポリゴン).
+///
+///  @param[in] pl Polylibクラスオブジェクト
+///  @param[in] pgList 計算対象ポリゴングループのパス名リスト
+///
+CutTriangleStore::CutTriangleStore(const Polylib* pl,
+                                   const std::vector<std::string>* pgList)
+{
+  Vec3r min(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+  Vec3r max( FLT_MAX,  FLT_MAX,  FLT_MAX);
+  collect(pl, pgList, min, max);
+  cache = new CutTriangleCache(triList);
+}
+
+
+/// コンストラクタ(検索領域指定).
+///
+///  @param[in] pl Polylibクラスオブジェクト
+///  @param[in] pgList 計算対象ポリゴングループのパス名リスト
+///  @param[in] min,max 検索領域
+///
+CutTriangleStore::CutTriangleStore(const Polylib* pl,
+                                   const std::vector<std::string>* pgList,
+                                   const Vec3r& min, const Vec3r& max)
+{
+  collect(pl, pgList, min, max);
+  cache = new CutTriangleCache(triList);
+}
+
+
+/// 検索領域と交わる三角形ポリゴンを収集.
+///
+///  ポリゴングループ毎に一度だけPolylib::search_polygonsを呼び出す
+///
+///  @param[in] pl Polylibクラスオブジェクト
+///  @param[in] pgList 計算対象ポリゴングループのパス名リスト
+///  @param[in] min,max 検索領域
+///
+void CutTriangleStore::collect(const Polylib* pl,
+                               const std::vector<std::string>* pgList,
+                               const Vec3r& min, const Vec3r& max)
+{
+  std::vector<std::string>::const_iterator pg;
+  for (pg = pgList->begin(); pg != pgList->end(); ++pg) {
+
+#ifdef CUTLIB_TIMING
+    Timer::Start(SEARCH_POLYGON);
+#endif
+
+    std::vector<Triangle*>* tList = pl->search_polygons(*pg, min, max, false);
+
+#ifdef CUTLIB_TIMING
+    Timer::Stop(SEARCH_POLYGON);
+#endif
+
+    std::vector<Triangle*>::const_iterator t;
+    for (t = tList->begin(); t != tList->end(); ++t) {
+      int exid = (*t)->get_exid();
+      if (0 < exid && exid < 256) {
+        Vertex** v = (*t)->get_vertex();
+        Vec3r tMin, tMax;
+        for (int a = 0; a < 3; a++) {
+          tMin[a] = std::min(std::min((*v[0])[a], (*v[1])[a]), (*v[2])[a]);
+          tMax[a] = std::max(std::max((*v[0])[a], (*v[1])[a]), (*v[2])[a]);
+        }
+        triList.push_back(*t);
+        bidList.push_back(exid);
+        bboxMin.push_back(tMin);
+        bboxMax.push_back(tMax);
+      }
+    }
+
+    delete tList;
+  }
+
+#ifdef CUTLIB_DEBUG
+  std::cout << "CutTriangleStore: " << triList.size() << " triangles" << std::endl;
+#endif
+}
+
+} // namespace cutlib
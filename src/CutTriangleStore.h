@@ -0,0 +1,143 @@
+/*
+###################################################################################
+#
+# Cutlib - Cut Information Library
+#
+# Copyright (c) 2010-2011 VCAD System Research Program, RIKEN.
+# All rights reserved.
+#
+# Copyright (c) 2012-2015 Advanced Institute for Computational Science, RIKEN.
+# All rights reserved.
+#
+# Copyright (c) 2016-2017 Research Institute for Information Technology (RIIT), Kyushu University.
+# All rights reserved.
+#
+###################################################################################
+*/
+
+/// @file
+/// @brief 計算対象三角形ポリゴン格納クラス 宣言
+///
+
+#ifndef CUTLIB_TRIANGLE_STORE_H
+#define CUTLIB_TRIANGLE_STORE_H
+
+#include <string>
+#include <vector>
+
+#include "CutInfo/CutInfo.h"
+#include "CutGridLattice.h"
+#include "CutTriangleCache.h"
+
+#include "Polylib.h"
+using namespace PolylibNS;
+
+namespace cutlib {
+
+/// 計算対象三角形ポリゴン格納クラス.
+///
+///  計算対象ポリゴングループを一度だけ解決し，計算対象領域と交わる
+///  三角形ポリゴンを境界ID,BBox付きの一次元配列として保持する.
+///  境界IDが範囲外(0以下,256以上)の三角形ポリゴンは格納しない.
+///  各交点計算エンジンは三角形番号(格納順)で参照する.
+///
+class CutTriangleStore {
+
+  enum { X, Y, Z };
+
+  std::vector<Triangle*> triList;  ///< 三角形ポリゴンリスト
+  std::vector<BidType> bidList;    ///< 三角形ポリゴンの境界IDリスト
+  std::vector<Vec3r> bboxMin;      ///< 三角形ポリゴンのBBox最小値
+  std::vector<Vec3r> bboxMax;      ///< 三角形ポリゴンのBBox最大値
+  CutTriangleCache* cache;         ///< 交点計算用三角形ポリゴンキャッシュ
+
+public:
+
+  /// コンストラクタ.
+  ///
+  ///  @param[in] pl Polylibクラスオブジェクト
+  ///  @param[in] pgList 計算対象ポリゴングループのパス名リスト
+  ///  @param[in] lattice 計算対象領域の直交格子座標テーブル
+  ///
+  CutTriangleStore(const Polylib* pl, const std::vector<std::string>* pgList,
+                   const CutGridLattice* lattice);
+
+  /// コンストラクタ(全三角形ポリゴン).
+  ///
+  ///  @param[in] pl Polylibクラスオブジェクト
+  ///  @param[in] pgList 計算対象ポリゴングループのパス名リスト
+  ///
+  CutTriangleStore(const Polylib* pl, const std::vector<std::string>* pgList);
+
+  /// コンストラクタ(検索領域指定).
+  ///
+  ///  @param[in] pl Polylibクラスオブジェクト
+  ///  @param[in] pgList 計算対象ポリゴングループのパス名リスト
+  ///  @param[in] min,max 検索領域
+  ///
+  CutTriangleStore(const Polylib* pl, const std::vector<std::string>* pgList,
+                   const Vec3r& min, const Vec3r& max);
+
+  /// デストラクタ.
+  ~CutTriangleStore() { delete cache; }
+
+  /// 三角形ポリゴンの総数を得る.
+  size_t getNumTriangle() const { return triList.size(); }
+
+  /// 三角形ポリゴンを得る.
+  Triangle* getTriangle(int id) const { return triList[id]; }
+
+  /// 三角形ポリゴンの境界IDを得る.
+  BidType getBid(int id) const { return bidList[id]; }
+
+  /// 三角形ポリゴンのBBox最小値を得る.
+  const Vec3r& getBBoxMin(int id) const { return bboxMin[id]; }
+
+  /// 三角形ポリゴンのBBox最大値を得る.
+  const Vec3r& getBBoxMax(int id) const { return bboxMax[id]; }
+
+  /// 交点計算用三角形ポリゴンキャッシュを得る.
+  const CutTriangleCache* getCache() const { return cache; }
+
+  /// 三角形ポリゴンのBBoxが直方体領域と交わるかの判定.
+  ///
+  ///  @param[in] id 三角形番号
+  ///  @param[in] min,max 直方体頂点座標
+  ///  @return true:交わる/false:交わらない
+  ///
+  bool overlap(int id, const Vec3r& min, const Vec3r& max) const {
+    const Vec3r& tMin = bboxMin[id];
+    const Vec3r& tMax = bboxMax[id];
+    if (tMin[X] > max[X] || tMax[X] < min[X]) return false;
+    if (tMin[Y] > max[Y] || tMax[Y] < min[Y]) return false;
+    if (tMin[Z] > max[Z] || tMax[Z] < min[Z]) return false;
+    return true;
+  }
+
+  /// 三角形ポリゴンのBBoxがa方向の区間と交わるかの判定.
+  ///
+  ///  @param[in] id 三角形番号
+  ///  @param[in] a 方向(X,Y,Z)
+  ///  @param[in] min,max 区間
+  ///  @return true:交わる/false:交わらない
+  ///
+  bool overlap(int id, int a, double min, double max) const {
+    return !(bboxMin[id][a] > max || bboxMax[id][a] < min);
+  }
+
+private:
+
+  /// 検索領域と交わる三角形ポリゴンを収集.
+  ///
+  ///  @param[in] pl Polylibクラスオブジェクト
+  ///  @param[in] pgList 計算対象ポリゴングループのパス名リスト
+  ///  @param[in] min,max 検索領域
+  ///
+  void collect(const Polylib* pl, const std::vector<std::string>* pgList,
+               const Vec3r& min, const Vec3r& max);
+
+};
+
+} // namespace cutlib
+
+#endif // CUTLIB_TRIANGLE_STORE_H
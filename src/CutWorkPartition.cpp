@@ -0,0 +1,158 @@
+/*
+###################################################################################
+#
+# Cutlib - Cut Information Library
+#
+# Copyright (c) 2010-2011 VCAD System Research Program, RIKEN.
+# All rights reserved.
+#
+# Copyright (c) 2012-2015 Advanced Institute for Computational Science, RIKEN.
+# All rights reserved.
+#
+# Copyright (c) 2016-2017 Research Institute for Information Technology (RIIT), Kyushu University.
+# All rights reserved.
+#
+###################################################################################
+*/
+
+
+/// @file
+/// @brief 負荷分散ブロック分割クラス 実装
+///
+
+#include "CutWorkPartition.h"
+
+#include <cmath>   // for fabs
+#ifdef CUTLIB_DEBUG
+#include <iostream>
+#endif
+
+namespace cutlib {
+
+/// コンストラクタ.
+///
+///  @param[in] occupancy 三角形ポリゴン占有ブリック
+///  @param[in] nThread スレッド数
+///  @param[in] partsPerThread スレッド当たりワークブロック数
+///
+CutWorkPartition::CutWorkPartition(const CutOccupancy* occupancy,
+                                   int nThread, int partsPerThread)
+  : occupancy(occupancy)
+{
+  size_t nBrick = occupancy->getNumBrick();
+  if (nBrick == 0) return;
+
+  brickCost.resize(nBrick);
+  double total = 0.0;
+  for (size_t b = 0; b < nBrick; b++) {
+    brickCost[b] = calcBrickCost(b);
+    total += brickCost[b];
+  }
+
+  size_t s[3] = { 0, 0, 0 };
+  size_t e[3];
+  for (int a = 0; a < 3; a++) e[a] = occupancy->getNumBrick(a);
+  int nPart = nThread * partsPerThread;
+  if ((size_t)nPart > nBrick) nPart = (int)nBrick;
+  split(s, e, nPart, total);
+
+#ifdef CUTLIB_DEBUG
+  std::cout << "CutWorkPartition: " << getNumPart() << " parts, "
+            << "estimated imbalance " << getImbalance() << std::endl;
+#endif
+}
+
+
+/// ブリック直方体を再帰的に二分割してワークブロックを作成.
+///
+///  左右のワークブロック数をnPart/2,nPart-nPart/2とし，
+///  左側の累積コストがcost*(nPart/2)/nPartに最も近い位置で区切る
+///
+///  @param[in] s 開始ブリック座標
+///  @param[in] e 終了ブリック座標の次
+///  @param[in] nPart 作成するワークブロック数
+///  @param[in] cost 直方体の見積もりコスト
+///
+void CutWorkPartition::split(const size_t s[], const size_t e[],
+                             int nPart, double cost)
+{
+  // 最も長い辺(同じ長さではk,j,iの順)
+  int axis = 2;
+  for (int a = 1; a >= 0; a--) {
+    if (e[a] - s[a] > e[axis] - s[axis]) axis = a;
+  }
+  size_t len = e[axis] - s[axis];
+
+  if (nPart <= 1 || len <= 1) {
+    Part part;
+    for (int a = 0; a < 3; a++) {
+      part.s[a] = s[a];
+      part.e[a] = e[a];
+    }
+    part.cost = cost;
+    parts.push_back(part);
+    return;
+  }
+
+  // axis方向の各スラブのコスト
+  std::vector<double> slab(len, 0.0);
+  for (size_t bk = s[2]; bk < e[2]; bk++) {
+    for (size_t bj = s[1]; bj < e[1]; bj++) {
+      for (size_t bi = s[0]; bi < e[0]; bi++) {
+        size_t bc[3] = { bi, bj, bk };
+        slab[bc[axis] - s[axis]] += brickCost[occupancy->getBrickIndex(bi, bj, bk)];
+      }
+    }
+  }
+
+  int nLeft = nPart / 2;
+  double target = cost * nLeft / nPart;
+  size_t cut = 1;
+  double sum = slab[0];
+  double left = sum;
+  for (size_t m = 2; m < len; m++) {
+    sum += slab[m-1];
+    if (std::fabs(sum - target) < std::fabs(left - target)) {
+      cut = m;
+      left = sum;
+    }
+  }
+
+  size_t mid[3] = { s[0], s[1], s[2] };
+  size_t end[3] = { e[0], e[1], e[2] };
+  mid[axis] = s[axis] + cut;
+  end[axis] = s[axis] + cut;
+  split(s, end, nLeft, left);
+  split(mid, e, nPart - nLeft, cost - left);
+}
+
+
+/// ブリックbの見積もりコストを計算.
+///
+///  占有ブリックは(セル数)x(固定コスト+三角形ポリゴン数)，
+///  非占有ブリックは探索を省略するため定数とする
+///
+double CutWorkPartition::calcBrickCost(size_t b) const
+{
+  if (!occupancy->isOccupied(b)) return EmptyBrickCost;
+  int s[3], e[3];
+  occupancy->getBrickRange(b, s, e);
+  double nCell = (double)(e[0] - s[0]) * (e[1] - s[1]) * (e[2] - s[2]);
+  return nCell * (CellCost + occupancy->getCount(b));
+}
+
+
+/// ワークブロックの見積もりコストの不均衡度(最大/平均)を得る.
+double CutWorkPartition::getImbalance() const
+{
+  if (parts.empty()) return 1.0;
+  double max = 0.0;
+  double sum = 0.0;
+  for (size_t p = 0; p < parts.size(); p++) {
+    if (parts[p].cost > max) max = parts[p].cost;
+    sum += parts[p].cost;
+  }
+  return sum > 0.0 ? max * parts.size() / sum : 1.0;
+}
+
+} // namespace cutlib
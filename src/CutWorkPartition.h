@@ -0,0 +1,122 @@
+/*
+###################################################################################
+#
+# Cutlib - Cut Information Library
+#
+# Copyright (c) 2010-2011 VCAD System Research Program, RIKEN.
+# All rights reserved.
+#
+# Copyright (c) 2012-2015 Advanced Institute for Computational Science, RIKEN.
+# All rights reserved.
+#
+# Copyright (c) 2016-2017 Research Institute for Information Technology (RIIT), Kyushu University.
+# All rights reserved.
+#
+###################################################################################
+*/
+
+
+/// @file
+/// @brief 負荷分散ブロック分割クラス 宣言
+///
+
+#ifndef CUTLIB_WORK_PARTITION_H
+#define CUTLIB_WORK_PARTITION_H
+
+#include <vector>
+
+#include "CutOccupancy.h"
+
+namespace cutlib {
+
+/// 負荷分散ブロック分割クラス.
+///
+///  ブリック毎の三角形ポリゴン数からセル毎の探索コストを見積もり，
+///  ブリックの直方体を再帰的に二分割して，見積もりコストがほぼ等しい
+///  直方体(ワークブロック)を作る.
+///  分割は最も長い辺(同じ長さではk,j,iの順)に垂直に行い，
+///  両側のワークブロック数の比にコストを分ける位置で区切る.
+///  ワークブロックは分割の木の左(座標の小さい側)から順に番号を付けるため，
+///  連続する番号のワークブロックは空間的にまとまった領域となる.
+///
+class CutWorkPartition {
+
+  /// ワークブロック.
+  struct Part {
+    size_t s[3];  ///< 開始ブリック座標
+    size_t e[3];  ///< 終了ブリック座標の次
+    double cost;  ///< 見積もりコスト
+  };
+
+  const CutOccupancy* occupancy;  ///< 三角形ポリゴン占有ブリック
+
+  std::vector<double> brickCost;  ///< ブリック毎の見積もりコスト
+  std::vector<Part> parts;        ///< ワークブロック
+
+public:
+
+  /// 占有ブリックのセル1個当たりの固定コスト(三角形ポリゴン1個の交点計算を1とする).
+  static const int CellCost = 4;
+
+  /// 非占有ブリック1個当たりのコスト.
+  static const int EmptyBrickCost = 1;
+
+  /// デフォルトのスレッド当たりワークブロック数.
+  static const int DefaultPartsPerThread = 4;
+
+  /// コンストラクタ.
+  ///
+  ///  @param[in] occupancy 三角形ポリゴン占有ブリック
+  ///  @param[in] nThread スレッド数
+  ///  @param[in] partsPerThread スレッド当たりワークブロック数
+  ///
+  CutWorkPartition(const CutOccupancy* occupancy, int nThread,
+                   int partsPerThread = DefaultPartsPerThread);
+
+  /// デストラクタ.
+  ~CutWorkPartition() {}
+
+  /// 三角形ポリゴン占有ブリックを得る.
+  const CutOccupancy* getOccupancy() const { return occupancy; }
+
+  /// ワークブロック数を得る.
+  int getNumPart() const { return (int)parts.size(); }
+
+  /// ワークブロックpのブリック座標範囲を得る.
+  ///
+  ///  @param[in] p ワークブロック番号
+  ///  @param[out] s 開始ブリック座標
+  ///  @param[out] e 終了ブリック座標の次
+  ///
+  void getPartRange(int p, size_t s[], size_t e[]) const {
+    for (int a = 0; a < 3; a++) {
+      s[a] = parts[p].s[a];
+      e[a] = parts[p].e[a];
+    }
+  }
+
+  /// ワークブロックpの見積もりコストを得る.
+  double getPartCost(int p) const { return parts[p].cost; }
+
+  /// ワークブロックの見積もりコストの不均衡度(最大/平均)を得る.
+  double getImbalance() const;
+
+private:
+
+  /// ブリックbの見積もりコストを計算.
+  double calcBrickCost(size_t b) const;
+
+  /// ブリック直方体を再帰的に二分割してワークブロックを作成.
+  ///
+  ///  @param[in] s 開始ブリック座標
+  ///  @param[in] e 終了ブリック座標の次
+  ///  @param[in] nPart 作成するワークブロック数
+  ///  @param[in] cost 直方体の見積もりコスト
+  ///
+  void split(const size_t s[], const size_t e[], int nPart, double cost);
+
+};
+
+} // namespace cutlib
+
+#endif // CUTLIB_WORK_PARTITION_H
@@ -21,9 +21,19 @@
 
 #include <string>
 #include <vector>
+#include <algorithm>   // for min
 
 #include "Cutlib.h"
+#include "CalcCutInfoT.h"
+#include "CutBinIndex.h"
+#include "CutBvh.h"
+#include "CutContext.h"
+#include "CutOccupancy.h"
+#include "CutScanline.h"
+#include "CutScatter.h"
 #include "CutSearch.h"
+#include "CutWorkPartition.h"
+#include "CutTriangleStore.h"
 
 #ifdef CUTLIB_OCTREE
 #include "CutOctree.h"
@@ -104,108 +114,89 @@ std::vector<std::string>* createPolygonGroupPathList(const Polylib* pl)
   return pgList;
 }
 
-} // namespace ANONYMOUS
+
+/// OpenMPの最大スレッド数を得る.
+int getNumThread()
+{
+#ifdef _OPENMP
+  return omp_get_max_threads();
+#else
+  return 1;
+#endif
+}
 
 
-/// 交点情報計算: 計算領域指定.
+/// 交点情報計算: 計算対象三角形ポリゴン,BVH構築済み.
 ///
 ///  @param[in] ista 計算基準点開始位置3次元インデクス
 ///  @param[in] nlen 計算基準点3次元サイズ
 ///  @param[in] grid GridAccessorクラスオブジェクト
-///  @param[in] pl Polylibクラスオブジェクト
+///  @param[in] lattice 計算対象領域の直交格子座標テーブル
+///  @param[in] store 計算対象三角形ポリゴン
+///  @param[in] cutBvh BVH(CL_ENGINE_BVHまたは直交格子でない時以外は0)
 ///  @param[in,out] cutPos 交点座標配列ラッパ
 ///  @param[in,out] cutBid 境界ID配列ラッパ
 ///  @param[in,out] cutNormal 法線ベクトル格納クラス
+///  @param[in] engine 交点計算エンジン
+///  @param[in,out] cutPolygonList スレッド毎の交点ポリゴンリスト(cutNormal=0の時は0)
+///  @param[in] nThread スレッド数(交点ポリゴンリスト数)
 ///
-CutlibReturn CalcCutInfo(const int ista[], const size_t nlen[],
-                         const GridAccessor* grid, const Polylib* pl,
-                         CutPosArray* cutPos, CutBidArray* cutBid,
-                         CutNormalArray* cutNormal)
+void calcCutInfo(const int ista[], const size_t nlen[],
+                 const GridAccessor* grid, const CutGridLattice* lattice,
+                 const CutTriangleStore* store, const CutBvh* cutBvh,
+                 CutPosArray* cutPos, CutBidArray* cutBid,
+                 CutNormalArray* cutNormal, CutlibEngine engine,
+                 CutPolygonList* cutPolygonList, int nThread)
 {
-  {
-    // check input parameters
-    CutlibReturn ret;
-    ret = checkSize("CalcCutInfo", "cutPos", ista, nlen, cutPos);
-    if (ret != CL_SUCCESS) return ret;
-    ret = checkSize("CalcCutInfo", "cutBid", ista, nlen, cutBid);
-    if (ret != CL_SUCCESS) return ret;
-    if (cutNormal) {
-      ret = checkSize("CalcCutInfo", "cutNormal", ista, nlen, cutNormal);
-      if (ret != CL_SUCCESS) return ret;
-    }
-    ret = checkPolylib("CalcCutInfo", pl);
-    if (ret != CL_SUCCESS) return ret;
-  }
+  // 直交格子でない時は方向毎のテーブルを使う索引,エンジンは使えないため，
+  // BVHによるセル毎探索(getSearchRangeによる)で計算する
+  bool separable = lattice->isSeparable();
+  if (!separable) engine = CL_ENGINE_BVH;
 
 #ifdef CUTLIB_TIMING
-  Timer::Start(TOTAL);
+  Timer::Start(BUILD_INDEX);
 #endif
-
-  std::vector<std::string>* pgList = createPolygonGroupPathList(pl);
-
-  CutSearch* cutSearch = new CutSearch(pl, pgList);
-
-  cutPos->clear();
-  cutBid->clear();
-
-  CutPolygonList* cutPolygonList = 0;
-  int nThread;
-#ifdef _OPENMP
-  nThread = omp_get_max_threads();
-#else
-  nThread = 1;
-#endif
-  if (cutNormal) cutPolygonList = new CutPolygonList[nThread];
-
-#ifdef CUTLIB_TIMING
-  Timer::Start(MAIN_LOOP);
-#endif
-#pragma omp parallel
-  {
-  int iThread;
-#ifdef _OPENMP
-  iThread = omp_get_thread_num();
-#else
-  iThread = 0;
-#endif
-#pragma omp for schedule(dynamic), collapse(2)
-  for (int k = ista[2]; k < ista[2]+nlen[2]; k++) {
-    for (int j = ista[1]; j < ista[1]+nlen[1]; j++) {
-      for (int i = ista[0]; i < ista[0]+nlen[0]; i++) {
-        double pos6[6];
-        float pos6_f[6];
-        BidType bid6[6];
-        Triangle* tri6[6];
-        double center[3];
-        double range[6];
-
+  CutBinIndex* cutBinIndex = 0;
+  if (engine != CL_ENGINE_BVH && engine != CL_ENGINE_SCATTER) {
+    cutBinIndex = new CutBinIndex(lattice, store);
+  }
+  CutOccupancy* cutOccupancy = 0;
+  CutWorkPartition* cutPartition = 0;
+  if (separable && (engine == CL_ENGINE_CELL || engine == CL_ENGINE_BVH)) {
+    cutOccupancy = new CutOccupancy(lattice, store);
+    cutPartition = new CutWorkPartition(cutOccupancy, nThread);
+  }
 #ifdef CUTLIB_TIMING
-        Timer::Start(THREAD_TOTAL);
+  Timer::Stop(BUILD_INDEX);
 #endif
-        grid->getSearchRange(i, j, k, center, range);
-        cutSearch->search(center, range, pos6, bid6, tri6);
-
-        for (int d = 0; d < 6; d++) pos6_f[d] = (float)(pos6[d]/range[d]);
 
-        cutPos->setPos(i, j, k, pos6_f);
-        cutBid->setBid(i, j, k, bid6);
-
-        if (cutNormal) {
-          for (int d = 0; d < 6; d++) {
-            if (bid6[d] > 0) {
-              CutPolygon* p = new CutPolygon(cutNormal->getIndex(i, j, k), d, tri6[d]);
-              cutPolygonList[iThread].push_back(p);
-            }
-          }
-        }
+  // セル毎探索では交点座標配列,境界ID配列はCalcCutInfoTでクリア
+  if (engine == CL_ENGINE_SCANLINE || engine == CL_ENGINE_SCATTER) {
+    cutPos->clear();
+    cutBid->clear();
+  }
+  if (cutNormal) cutNormal->clear();
 
 #ifdef CUTLIB_TIMING
-        Timer::Stop(THREAD_TOTAL);
+  Timer::Start(MAIN_LOOP);
 #endif
-      }
+  if (engine == CL_ENGINE_SCANLINE) {
+    CutScanline* cutScanline = new CutScanline(cutBinIndex);
+    for (int a = 0; a < 3; a++) {
+      cutScanline->search(a, cutPos, cutBid, cutNormal, cutPolygonList);
     }
+    delete cutScanline;
+  } else if (engine == CL_ENGINE_SCATTER) {
+    CutScatter* cutScatter = new CutScatter(lattice, store);
+    cutScatter->search(cutPos, cutBid, cutNormal, cutPolygonList);
+    delete cutScatter;
+  } else {
+    CutSearch* cutSearch = cutBvh ? new CutSearch(cutBvh)
+                                  : new CutSearch(cutBinIndex);
+    CalcCutInfoT(ista, nlen, grid, cutSearch, cutPartition, cutPos, cutBid,
+                 cutNormal, cutPolygonList);
+    delete cutSearch;
   }
-  } // parallel reagion
 #ifdef CUTLIB_TIMING
   Timer::Stop(MAIN_LOOP);
 #endif
@@ -220,25 +211,145 @@ CutlibReturn CalcCutInfo(const int ista[], const size_t nlen[],
 #endif
   }
 
-  delete cutSearch;
-  delete pgList;
-  delete[] cutPolygonList;
+  delete cutPartition;
+  delete cutOccupancy;
+  delete cutBinIndex;
+}
+
 
 #ifdef CUTLIB_TIMING
-  Timer::Stop(TOTAL);
+
+/// タイミング情報の出力.
+void printTiming(const CutNormalArray* cutNormal)
+{
   Timer::Print(TOTAL, "Total");
+  Timer::Print(BUILD_INDEX, "Build Index");
   Timer::Print(MAIN_LOOP, "Main Loop");
   if (cutNormal) {
     Timer::Print(PACK_NORMAL, "Pack Normal");
   }
   Timer::PrintFull(THREAD_TOTAL, "Theread Total");
-  Timer::PrintFull(SEARCH_POLYGON, "Polylib::search_polygons");
-#endif
+  Timer::PrintImbalance(THREAD_TOTAL, "Theread Total");
+  Timer::Print(SEARCH_POLYGON, "Collect Triangles");
+}
+
+#endif // CUTLIB_TIMING
+
+
+/// ストリーミング計算用配列のチェック.
+CutlibReturn checkSlabArrays(const char* funcName,
+                             const int ista[], const size_t nlen[],
+                             int slabDepth, CutPosArray* cutPos,
+                             CutBidArray* cutBid, CutNormalArray* cutNormal)
+{
+  if (slabDepth <= 0) {
+    std::cerr << "*** " << funcName << ": bad slab depth: "
+              << slabDepth << std::endl;
+    return CL_OTHER_ERROR;
+  }
 
+  // 最初のスラブで確認すれば残りのスラブも配列に収まる.
+  // 全配列を確認してから開始位置を変更する(エラー時は配列を変更しない)
+  CutInfoArray* arrays[3] = { cutPos, cutBid, cutNormal };
+  const char* names[3] = { "cutPos", "cutBid", "cutNormal" };
+  size_t slabLen[3] = { nlen[0], nlen[1],
+                        std::min(nlen[2], (size_t)slabDepth) };
+  for (int a = 0; a < 3; a++) {
+    if (!arrays[a]) continue;
+    // z方向はsetStart後と同じく配列の開始位置からslabLen[2]が収まるか確認
+    int slabSta[3] = { ista[0], ista[1], arrays[a]->getStartZ() };
+    CutlibReturn ret = checkSize(funcName, names[a], slabSta, slabLen, arrays[a]);
+    if (ret != CL_SUCCESS) return ret;
+  }
+  for (int a = 0; a < 3; a++) {
+    if (!arrays[a]) continue;
+    arrays[a]->setStart(arrays[a]->getStartX(), arrays[a]->getStartY(), ista[2]);
+  }
   return CL_SUCCESS;
 }
 
 
+/// 交点情報計算: z方向スラブ単位のストリーミング計算本体.
+///
+///  @param[in] ista 計算基準点開始位置3次元インデクス
+///  @param[in] nlen 計算基準点3次元サイズ
+///  @param[in] grid GridAccessorクラスオブジェクト
+///  @param[in] store 計算対象三角形ポリゴン(計算領域全体)
+///  @param[in] cutBvh BVH(CL_ENGINE_BVHまたは直交格子でない時以外は0)
+///  @param[in] handler スラブ単位交点情報受け取りクラス
+///  @param[in] slabDepth スラブのz方向セル数
+///  @param[in,out] cutPos スラブ用交点座標配列ラッパ
+///  @param[in,out] cutBid スラブ用境界ID配列ラッパ
+///  @param[in,out] cutNormal スラブ用法線ベクトル格納クラス
+///  @param[in] engine 交点計算エンジン
+///  @param[in,out] cutPolygonList スレッド毎の交点ポリゴンリスト(cutNormal=0の時は0)
+///  @param[in] nThread スレッド数(交点ポリゴンリスト数)
+///
+void calcCutInfoStreaming(const int ista[], const size_t nlen[],
+                          const GridAccessor* grid,
+                          const CutTriangleStore* store, const CutBvh* cutBvh,
+                          CutSlabHandler* handler, int slabDepth,
+                          CutPosArray* cutPos, CutBidArray* cutBid,
+                          CutNormalArray* cutNormal, CutlibEngine engine,
+                          CutPolygonList* cutPolygonList, int nThread)
+{
+  int kEnd = ista[2] + (int)nlen[2];
+  for (int k0 = ista[2]; k0 < kEnd; k0 += slabDepth) {
+    int k1 = std::min(k0 + slabDepth, kEnd);
+    int slabSta[3] = { ista[0], ista[1], k0 };
+    size_t slabLen[3] = { nlen[0], nlen[1], (size_t)(k1 - k0) };
+
+    cutPos->setStart(cutPos->getStartX(), cutPos->getStartY(), k0);
+    cutBid->setStart(cutBid->getStartX(), cutBid->getStartY(), k0);
+    if (cutNormal) {
+      cutNormal->setStart(cutNormal->getStartX(), cutNormal->getStartY(), k0);
+    }
+
+    CutGridLattice lattice(slabSta, slabLen, grid);
+    calcCutInfo(slabSta, slabLen, grid, &lattice, store, cutBvh,
+                cutPos, cutBid, cutNormal, engine, cutPolygonList, nThread);
+
+    handler->processSlab(k0, k1, cutPos, cutBid, cutNormal);
+  }
+}
+
+} // namespace ANONYMOUS
+
+
+/// 交点情報計算: 計算領域指定.
+///
+///  @param[in] ista 計算基準点開始位置3次元インデクス
+///  @param[in] nlen 計算基準点3次元サイズ
+///  @param[in] grid GridAccessorクラスオブジェクト
+///  @param[in] pl Polylibクラスオブジェクト
+///  @param[in,out] cutPos 交点座標配列ラッパ
+///  @param[in,out] cutBid 境界ID配列ラッパ
+///  @param[in,out] cutNormal 法線ベクトル格納クラス
+///  @param[in] engine 交点計算エンジン
+///
+CutlibReturn CalcCutInfo(const int ista[], const size_t nlen[],
+                         const GridAccessor* grid, const Polylib* pl,
+                         CutPosArray* cutPos, CutBidArray* cutBid,
+                         CutNormalArray* cutNormal, CutlibEngine engine)
+{
+  {
+    // check input parameters
+    CutlibReturn ret;
+    ret = checkPolylib("CalcCutInfo", pl);
+    if (ret != CL_SUCCESS) return ret;
+  }
+
+  std::vector<std::string>* pgList = createPolygonGroupPathList(pl);
+
+  CutlibReturn ret = CalcCutInfo(ista, nlen, grid, pl, pgList,
+                                 cutPos, cutBid, cutNormal, engine);
+
+  delete pgList;
+
+  return ret;
+}
+
+
 /// 交点情報計算: 計算領域指定.
 ///
 ///  @param[in] ista 計算基準点開始位置3次元インデクス
@@ -249,12 +360,13 @@ CutlibReturn CalcCutInfo(const int ista[], const size_t nlen[],
 ///  @param[in,out] cutPos 交点座標配列ラッパ
 ///  @param[in,out] cutBid 境界ID配列ラッパ
 ///  @param[in,out] cutNormal 法線ベクトル格納クラス
+///  @param[in] engine 交点計算エンジン
 ///
 CutlibReturn CalcCutInfo(const int ista[], const size_t nlen[],
                          const GridAccessor* grid,
 												 const Polylib* pl, std::vector<std::string>* pgList,
                          CutPosArray* cutPos, CutBidArray* cutBid,
-                         CutNormalArray* cutNormal)
+                         CutNormalArray* cutNormal, CutlibEngine engine)
 {
   {
     // check input parameters
@@ -273,106 +385,230 @@ CutlibReturn CalcCutInfo(const int ista[], const size_t nlen[],
 
 #ifdef CUTLIB_TIMING
   Timer::Start(TOTAL);
+  Timer::Start(BUILD_INDEX);
+#endif
+  CutGridLattice* lattice = new CutGridLattice(ista, nlen, grid);
+  CutTriangleStore* store = new CutTriangleStore(pl, pgList, lattice);
+  CutBvh* cutBvh = 0;
+  if (engine == CL_ENGINE_BVH || !lattice->isSeparable()) {
+    cutBvh = new CutBvh(store);
+  }
+#ifdef CUTLIB_TIMING
+  Timer::Stop(BUILD_INDEX);
 #endif
 
-//  std::vector<std::string>* pgList = createPolygonGroupPathList(pl);
+  int nThread = getNumThread();
+  CutPolygonList* cutPolygonList = 0;
+  if (cutNormal) cutPolygonList = new CutPolygonList[nThread];
 
-  CutSearch* cutSearch = new CutSearch(pl, pgList);
+  calcCutInfo(ista, nlen, grid, lattice, store, cutBvh,
+              cutPos, cutBid, cutNormal, engine, cutPolygonList, nThread);
 
-  cutPos->clear();
-  cutBid->clear();
+  delete cutBvh;
+  delete store;
+  delete lattice;
+  delete[] cutPolygonList;
 
-  CutPolygonList* cutPolygonList = 0;
-  int nThread;
-#ifdef _OPENMP
-  nThread = omp_get_max_threads();
-#else
-  nThread = 1;
+#ifdef CUTLIB_TIMING
+  Timer::Stop(TOTAL);
+  printTiming(cutNormal);
 #endif
-  if (cutNormal) cutPolygonList = new CutPolygonList[nThread];
+
+  return CL_SUCCESS;
+}
+
+
+/// 交点情報計算: 計算領域指定, コンテキスト使用.
+///
+///  @param[in] ista 計算基準点開始位置3次元インデクス
+///  @param[in] nlen 計算基準点3次元サイズ
+///  @param[in] grid GridAccessorクラスオブジェクト
+///  @param[in,out] ctx 交点情報計算コンテキスト
+///  @param[in,out] cutPos 交点座標配列ラッパ
+///  @param[in,out] cutBid 境界ID配列ラッパ
+///  @param[in,out] cutNormal 法線ベクトル格納クラス
+///  @param[in] engine 交点計算エンジン
+///
+CutlibReturn CalcCutInfo(const int ista[], const size_t nlen[],
+                         const GridAccessor* grid, CutContext* ctx,
+                         CutPosArray* cutPos, CutBidArray* cutBid,
+                         CutNormalArray* cutNormal, CutlibEngine engine)
+{
+  {
+    // check input parameters
+    CutlibReturn ret;
+    ret = checkSize("CalcCutInfo", "cutPos", ista, nlen, cutPos);
+    if (ret != CL_SUCCESS) return ret;
+    ret = checkSize("CalcCutInfo", "cutBid", ista, nlen, cutBid);
+    if (ret != CL_SUCCESS) return ret;
+    if (cutNormal) {
+      ret = checkSize("CalcCutInfo", "cutNormal", ista, nlen, cutNormal);
+      if (ret != CL_SUCCESS) return ret;
+    }
+    ret = checkPolylib("CalcCutInfo", ctx ? ctx->getPolylib() : 0);
+    if (ret != CL_SUCCESS) return ret;
+  }
 
 #ifdef CUTLIB_TIMING
-  Timer::Start(MAIN_LOOP);
+  Timer::Start(TOTAL);
+  Timer::Start(BUILD_INDEX);
 #endif
-#pragma omp parallel
-  {
-  int iThread;
-#ifdef _OPENMP
-  iThread = omp_get_thread_num();
-#else
-  iThread = 0;
+  CutGridLattice* lattice = new CutGridLattice(ista, nlen, grid);
+  const CutTriangleStore* store = ctx->getStore();
+  const CutBvh* cutBvh = 0;
+  if (engine == CL_ENGINE_BVH || !lattice->isSeparable()) {
+    cutBvh = ctx->getBvh();
+  }
+#ifdef CUTLIB_TIMING
+  Timer::Stop(BUILD_INDEX);
 #endif
-#pragma omp for schedule(dynamic), collapse(2)
-  for (int k = ista[2]; k < ista[2]+nlen[2]; k++) {
-    for (int j = ista[1]; j < ista[1]+nlen[1]; j++) {
-      for (int i = ista[0]; i < ista[0]+nlen[0]; i++) {
-        double pos6[6];
-        float pos6_f[6];
-        BidType bid6[6];
-        Triangle* tri6[6];
-        double center[3];
-        double range[6];
+
+  int nThread = getNumThread();
+  CutPolygonList* cutPolygonList = 0;
+  if (cutNormal) cutPolygonList = ctx->getPolygonList(nThread);
+
+  calcCutInfo(ista, nlen, grid, lattice, store, cutBvh,
+              cutPos, cutBid, cutNormal, engine, cutPolygonList, nThread);
+
+  delete lattice;
 
 #ifdef CUTLIB_TIMING
-        Timer::Start(THREAD_TOTAL);
+  Timer::Stop(TOTAL);
+  printTiming(cutNormal);
 #endif
-        grid->getSearchRange(i, j, k, center, range);
-        cutSearch->search(center, range, pos6, bid6, tri6);
 
-        for (int d = 0; d < 6; d++) pos6_f[d] = (float)(pos6[d]/range[d]);
+  return CL_SUCCESS;
+}
 
-        cutPos->setPos(i, j, k, pos6_f);
-        cutBid->setBid(i, j, k, bid6);
 
-        if (cutNormal) {
-          for (int d = 0; d < 6; d++) {
-            if (bid6[d] > 0) {
-              CutPolygon* p = new CutPolygon(cutNormal->getIndex(i, j, k), d, tri6[d]);
-              cutPolygonList[iThread].push_back(p);
-            }
-          }
-        }
+/// 交点情報計算: z方向スラブ単位のストリーミング計算.
+///
+///  @param[in] ista 計算基準点開始位置3次元インデクス
+///  @param[in] nlen 計算基準点3次元サイズ
+///  @param[in] grid GridAccessorクラスオブジェクト
+///  @param[in] pl Polylibクラスオブジェクト
+///  @param[in] handler スラブ単位交点情報受け取りクラス
+///  @param[in] slabDepth スラブのz方向セル数
+///  @param[in,out] cutPos スラブ用交点座標配列ラッパ
+///  @param[in,out] cutBid スラブ用境界ID配列ラッパ
+///  @param[in,out] cutNormal スラブ用法線ベクトル格納クラス
+///  @param[in] engine 交点計算エンジン
+///
+CutlibReturn CalcCutInfoStreaming(const int ista[], const size_t nlen[],
+                                  const GridAccessor* grid, const Polylib* pl,
+                                  CutSlabHandler* handler, int slabDepth,
+                                  CutPosArray* cutPos, CutBidArray* cutBid,
+                                  CutNormalArray* cutNormal, CutlibEngine engine)
+{
+  {
+    // check input parameters
+    CutlibReturn ret;
+    ret = checkSlabArrays("CalcCutInfoStreaming", ista, nlen, slabDepth,
+                          cutPos, cutBid, cutNormal);
+    if (ret != CL_SUCCESS) return ret;
+    ret = checkPolylib("CalcCutInfoStreaming", pl);
+    if (ret != CL_SUCCESS) return ret;
+  }
 
 #ifdef CUTLIB_TIMING
-        Timer::Stop(THREAD_TOTAL);
+  Timer::Start(TOTAL);
+  Timer::Start(BUILD_INDEX);
 #endif
-      }
-    }
+  std::vector<std::string>* pgList = createPolygonGroupPathList(pl);
+  CutGridLattice* lattice = new CutGridLattice(ista, nlen, grid);
+  CutTriangleStore* store = new CutTriangleStore(pl, pgList, lattice);
+  CutBvh* cutBvh = 0;
+  if (engine == CL_ENGINE_BVH || !lattice->isSeparable()) {
+    cutBvh = new CutBvh(store);
   }
-  } // parallel reagion
+  delete lattice;
+  delete pgList;
 #ifdef CUTLIB_TIMING
-  Timer::Stop(MAIN_LOOP);
+  Timer::Stop(BUILD_INDEX);
 #endif
 
-  if (cutNormal) {
+  int nThread = getNumThread();
+  CutPolygonList* cutPolygonList = 0;
+  if (cutNormal) cutPolygonList = new CutPolygonList[nThread];
+
+  calcCutInfoStreaming(ista, nlen, grid, store, cutBvh, handler, slabDepth,
+                       cutPos, cutBid, cutNormal, engine,
+                       cutPolygonList, nThread);
+
+  delete cutBvh;
+  delete store;
+  delete[] cutPolygonList;
+
 #ifdef CUTLIB_TIMING
-    Timer::Start(PACK_NORMAL);
+  Timer::Stop(TOTAL);
+  printTiming(cutNormal);
 #endif
-    cutNormal->setNormalInfo(cutPolygonList, nThread);
+
+  return CL_SUCCESS;
+}
+
+
+/// 交点情報計算: z方向スラブ単位のストリーミング計算, コンテキスト使用.
+///
+///  @param[in] ista 計算基準点開始位置3次元インデクス
+///  @param[in] nlen 計算基準点3次元サイズ
+///  @param[in] grid GridAccessorクラスオブジェクト
+///  @param[in,out] ctx 交点情報計算コンテキスト
+///  @param[in] handler スラブ単位交点情報受け取りクラス
+///  @param[in] slabDepth スラブのz方向セル数
+///  @param[in,out] cutPos スラブ用交点座標配列ラッパ
+///  @param[in,out] cutBid スラブ用境界ID配列ラッパ
+///  @param[in,out] cutNormal スラブ用法線ベクトル格納クラス
+///  @param[in] engine 交点計算エンジン
+///
+CutlibReturn CalcCutInfoStreaming(const int ista[], const size_t nlen[],
+                                  const GridAccessor* grid, CutContext* ctx,
+                                  CutSlabHandler* handler, int slabDepth,
+                                  CutPosArray* cutPos, CutBidArray* cutBid,
+                                  CutNormalArray* cutNormal, CutlibEngine engine)
+{
+  {
+    // check input parameters
+    CutlibReturn ret;
+    ret = checkSlabArrays("CalcCutInfoStreaming", ista, nlen, slabDepth,
+                          cutPos, cutBid, cutNormal);
+    if (ret != CL_SUCCESS) return ret;
+    ret = checkPolylib("CalcCutInfoStreaming", ctx ? ctx->getPolylib() : 0);
+    if (ret != CL_SUCCESS) return ret;
+  }
+
 #ifdef CUTLIB_TIMING
-    Timer::Stop(PACK_NORMAL);
-#endif
+  Timer::Start(TOTAL);
+  Timer::Start(BUILD_INDEX);
+#endif
+  const CutTriangleStore* store = ctx->getStore();
+  const CutBvh* cutBvh = 0;
+  if (engine == CL_ENGINE_BVH) {
+    cutBvh = ctx->getBvh();
+  } else {
+    CutGridLattice lattice(ista, nlen, grid);
+    if (!lattice.isSeparable()) cutBvh = ctx->getBvh();
   }
+#ifdef CUTLIB_TIMING
+  Timer::Stop(BUILD_INDEX);
+#endif
 
-  delete cutSearch;
-//  delete pgList;
-  delete[] cutPolygonList;
+  int nThread = getNumThread();
+  CutPolygonList* cutPolygonList = 0;
+  if (cutNormal) cutPolygonList = ctx->getPolygonList(nThread);
+
+  calcCutInfoStreaming(ista, nlen, grid, store, cutBvh, handler, slabDepth,
+                       cutPos, cutBid, cutNormal, engine,
+                       cutPolygonList, nThread);
 
 #ifdef CUTLIB_TIMING
   Timer::Stop(TOTAL);
-  Timer::Print(TOTAL, "Total");
-  Timer::Print(MAIN_LOOP, "Main Loop");
-  if (cutNormal) {
-    Timer::Print(PACK_NORMAL, "Pack Normal");
-  }
-  Timer::PrintFull(THREAD_TOTAL, "Theread Total");
-  Timer::PrintFull(SEARCH_POLYGON, "Polylib::search_polygons");
+  printTiming(cutNormal);
 #endif
 
   return CL_SUCCESS;
 }
 
-
 #ifdef CUTLIB_OCTREE
 
 /// 交点情報計算: Octree, リーフセルのみ.
@@ -400,7 +636,9 @@ CutlibReturn CalcCutInfoOctreeLeafCell(SklTree* tree, const Polylib* pl,
 
   std::vector<std::string>* pgList = createPolygonGroupPathList(pl);
 
-  CutSearch* cutSearch = new CutSearch(pl, pgList);
+  CutTriangleStore* store = new CutTriangleStore(pl, pgList);
+  CutBvh* cutBvh = new CutBvh(store);
+  CutSearch* cutSearch = new CutSearch(cutBvh);
 
 #ifdef CUTLIB_TIMING
   Timer::Start(MAIN_LOOP);
@@ -430,13 +668,15 @@ CutlibReturn CalcCutInfoOctreeLeafCell(SklTree* tree, const Polylib* pl,
 #endif
 
   delete cutSearch;
+  delete cutBvh;
+  delete store;
   delete pgList;
 
 #ifdef CUTLIB_TIMING
   Timer::Stop(TOTAL);
   Timer::Print(TOTAL, "Total");
   Timer::Print(MAIN_LOOP, "Main Loop");
-  Timer::Print(SEARCH_POLYGON, "Polylib::search_polygons");
+  Timer::Print(SEARCH_POLYGON, "Collect Triangles");
 #endif
 
   return CL_SUCCESS;
@@ -445,6 +685,8 @@ CutlibReturn CalcCutInfoOctreeLeafCell(SklTree* tree, const Polylib* pl,
 
 /// 交点情報計算: Octree, 全セル計算.
 ///
+/// ルートセル毎の三角形ポリゴン収集にはBVHを使用
+///
 ///  @param[in,out] tree SklTreeクラスオブジェクト
 ///  @param[in] pl Polylibクラスオブジェクト
 ///  @param cutPos 交点座標データアクセッサ
@@ -468,6 +710,9 @@ CutlibReturn CalcCutInfoOctreeAllCell(SklTree* tree, const Polylib* pl,
 
   std::vector<std::string>* pgList = createPolygonGroupPathList(pl);
 
+  CutTriangleStore* store = new CutTriangleStore(pl, pgList);
+  CutBvh* cutBvh = new CutBvh(store);
+
   size_t nx, ny, nz;
   tree->GetSize(nx, ny, nz);
 
@@ -485,7 +730,7 @@ CutlibReturn CalcCutInfoOctreeAllCell(SklTree* tree, const Polylib* pl,
         Vec3r max = Vec3r(org[0]+1.5*d[0], org[1]+1.5*d[1], org[2]+1.5*d[2]);
 
         cutOctree::CutTriangles ctList;
-        cutOctree::CutTriangle::AppendCutTriangles(ctList, pl, pgList, min, max);
+        cutOctree::CutTriangle::AppendCutTriangles(ctList, cutBvh, min, max);
 
         cutOctree::calcCutInfo(rootCell, org, d, cutPos, cutBid, ctList);
 
@@ -497,13 +742,15 @@ CutlibReturn CalcCutInfoOctreeAllCell(SklTree* tree, const Polylib* pl,
   Timer::Stop(MAIN_LOOP);
 #endif
 
+  delete cutBvh;
+  delete store;
   delete pgList;
 
 #ifdef CUTLIB_TIMING
   Timer::Stop(TOTAL);
   Timer::Print(TOTAL, "Total");
   Timer::Print(MAIN_LOOP, "Main Loop");
-  Timer::Print(SEARCH_POLYGON, "Polylib::search_polygons");
+  Timer::Print(SEARCH_POLYGON, "Collect Triangles");
 #endif
 
   return CL_SUCCESS;